@@ -0,0 +1,102 @@
+#include "FlowField.h"
+#include <queue>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+/**
+ * @brief Set the size of the grid and the goal, clear all blocked grids and build the whole field.
+ */
+void
+FlowField::reset(int width, int height, int goal) {
+	this->width = width;
+	this->height = height;
+	this->goal = goal;
+	dist.assign(width * height, unreachable);
+	next_cell.assign(width * height, -1);
+	blocked.assign(width * height, false);
+	dist[goal] = 0;
+	vector<int> frontier{goal};
+	_propagate(frontier);
+}
+
+/**
+ * @brief Block the grids and update the field.
+ * @details Blocking grids can only make routes longer, so only the grids whose route passed through a blocked grid (the subtree of the blocked grids along next_cell) have to be recomputed. They are cleared, then filled again from their neighbours outside the subtree.
+ * Grids that cannot reach the goal anymore are left unreachable.
+ */
+void
+FlowField::block(const vector<int> &cells) {
+	// Collect the grids whose route passed through a newly blocked grid.
+	vector<int> affected;
+	for(int c : cells) {
+		if(blocked[c]) continue;
+		blocked[c] = true;
+		affected.emplace_back(c);
+	}
+	for(size_t k = 0; k < affected.size(); ++k) {
+		int a = affected[k];
+		int nb[4];
+		_neighbours(a, nb);
+		for(int n : nb) {
+			if(n == -1 || blocked[n] || next_cell[n] != a) continue;
+			next_cell[n] = -1;
+			affected.emplace_back(n);
+		}
+		dist[a] = unreachable;
+		next_cell[a] = -1;
+	}
+	// Refill the affected grids from the untouched grids around them.
+	vector<int> frontier;
+	for(int a : affected) {
+		if(blocked[a]) continue;
+		int nb[4];
+		_neighbours(a, nb);
+		for(int n : nb) {
+			if(n == -1 || blocked[n] || dist[n] == unreachable) continue;
+			if(dist[n] + 1 < dist[a]) {
+				dist[a] = dist[n] + 1;
+				next_cell[a] = n;
+			}
+		}
+		if(dist[a] != unreachable) frontier.emplace_back(a);
+	}
+	_propagate(frontier);
+}
+
+/**
+ * @brief Get the 4-neighbouring grids (up, down, left, right) of a grid. Neighbours outside the field are -1.
+ */
+void
+FlowField::_neighbours(int cell, int (&res)[4]) const {
+	int x = cell % width, y = cell / width;
+	res[0] = (y > 0) ? cell - width : -1;
+	res[1] = (y + 1 < height) ? cell + width : -1;
+	res[2] = (x > 0) ? cell - 1 : -1;
+	res[3] = (x + 1 < width) ? cell + 1 : -1;
+}
+
+/**
+ * @brief Relax the distances outward from the frontier grids (Dijkstra with unit step cost).
+ */
+void
+FlowField::_propagate(const vector<int> &frontier) {
+	using Item = pair<int, int>;
+	priority_queue<Item, vector<Item>, greater<Item>> q;
+	for(int c : frontier)
+		q.emplace(dist[c], c);
+	while(!q.empty()) {
+		auto [d, c] = q.top();
+		q.pop();
+		if(d != dist[c]) continue;
+		int nb[4];
+		_neighbours(c, nb);
+		for(int n : nb) {
+			if(n == -1 || blocked[n] || d + 1 >= dist[n]) continue;
+			dist[n] = d + 1;
+			next_cell[n] = c;
+			q.emplace(dist[n], n);
+		}
+	}
+}
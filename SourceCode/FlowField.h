@@ -0,0 +1,56 @@
+#ifndef FLOWFIELD_H_INCLUDED
+#define FLOWFIELD_H_INCLUDED
+
+#include <vector>
+
+/**
+ * @brief Flow field over the level grid toward a single goal grid.
+ * @details For every grid, the field stores the number of steps to the goal and the neighbouring grid of the next step, so any number of monsters can find their way by only looking at the grid they are heading to. Grids are indexed by `y * width + x`, and monsters move between 4-neighbouring grids.
+ * Blocking grids (e.g. placing a tower) only recomputes the grids whose shortest route passed through the blocked grids.
+ * @see Level::is_open_map()
+ */
+class FlowField
+{
+public:
+	FlowField() {}
+	void reset(int width, int height, int goal);
+	void block(const std::vector<int> &cells);
+	bool is_reachable(int cell) const { return dist[cell] != unreachable; }
+	bool is_blocked(int cell) const { return blocked[cell]; }
+	int next(int cell) const { return next_cell[cell]; }
+	int distance(int cell) const { return dist[cell]; }
+	int get_goal() const { return goal; }
+	int get_width() const { return width; }
+	int get_height() const { return height; }
+private:
+	void _neighbours(int cell, int (&res)[4]) const;
+	void _propagate(const std::vector<int> &frontier);
+private:
+	static constexpr int unreachable = 0x3f3f3f3f;
+	/**
+	 * @var width
+	 * @brief Number of grids in x-direction.
+	 **
+	 * @var height
+	 * @brief Number of grids in y-direction.
+	 **
+	 * @var goal
+	 * @brief The grid every route leads to.
+	 **
+	 * @var dist
+	 * @brief Number of steps from each grid to the goal, or `unreachable`.
+	 **
+	 * @var next_cell
+	 * @brief The next grid on the shortest route from each grid, or -1 for the goal and unreachable grids.
+	 **
+	 * @var blocked
+	 * @brief Whether each grid is blocked.
+	 */
+	int width = 0, height = 0;
+	int goal = -1;
+	std::vector<int> dist;
+	std::vector<int> next_cell;
+	std::vector<char> blocked;
+};
+
+#endif
@@ -5,9 +5,14 @@
 #include "data/SoundCenter.h"
 #include "data/ImageCenter.h"
 #include "data/FontCenter.h"
+#include "data/TimerCenter.h"
+#include "data/JobCenter.h"
+#include "data/EventCenter.h"
 #include "Player.h"
 #include "Level.h"
 #include "hero/Hero.h"
+#include "monsters/MonsterSystem.h"
+#include <algorithm>
 #include <allegro5/allegro_primitives.h>
 #include <allegro5/allegro_font.h>
 #include <allegro5/allegro_ttf.h>
@@ -17,6 +22,7 @@
 #include <cstring>
 #include <string>
 #include <map>
+#include <thread>
 
 
 
@@ -34,24 +40,35 @@ constexpr char role3_img_path[] = "./assets/image/roles/role3_left.png";
 constexpr char game_start_sound_path[] = "./assets/sound/game_start.ogg";
 constexpr char background_sound_path[] = "./assets/sound/BackgroundMusic.ogg";
 constexpr char mainmenu_sound_path[] = "./assets/sound/menumusic.ogg";
+// fast-forward: simulation steps per frame of each speed, switched by key F
+constexpr int game_speeds[] = {1, 2, 4, 8, 16};
+// Steps of a frame stop once they have taken this fraction of the frame, so drawing still fits in time.
+constexpr double step_budget = 0.75;
+// The effective speed shown in the HUD is measured over windows of this many seconds.
+constexpr double speed_window = 0.5;
 
 /**
  * @brief Game entry.
  * @details The function processes all allegro events and update the event state to a generic data storage (i.e. DataCenter).
- * For timer event, the game_update and game_draw function will be called if and only if the current is timer.
+ * For timer event, the game_update function will be called. game_draw is called once all pending events are processed, so if updates fall behind the timer, frames are skipped instead of drawn late.
  */
 void
 Game::execute() {
 	DataCenter *DC = DataCenter::get_instance();
 	// main game loop
 	bool run = true;
+	bool redraw = false;
 	while(run) {
+		if(redraw && al_is_event_queue_empty(event_queue)) {
+			game_draw();
+			redraw = false;
+		}
 		// process all events here
 		al_wait_for_event(event_queue, &event);
 		switch(event.type) {
 			case ALLEGRO_EVENT_TIMER: {
 				run &= game_update();
-				game_draw();
+				redraw = true;
 				break;
 			} case ALLEGRO_EVENT_DISPLAY_CLOSE: { // stop game
 				run = false;
@@ -145,6 +162,10 @@ void Game::game_init() {
 	// init font setting
 	FC->init();
 
+	// the main thread also runs jobs, so one worker less than the hardware threads
+	unsigned hardware_threads = std::thread::hardware_concurrency();
+	JobCenter::get_instance()->init(hardware_threads > 1 ? hardware_threads - 1 : 0);
+
 	ui = new UI();
 	ui->init();
 
@@ -187,11 +208,10 @@ const int total_height = (3 * button_height) + (2 * button_spacing);
 
 bool Game::game_update() {
 	DataCenter *DC = DataCenter::get_instance();
-	OperationCenter *OC = OperationCenter::get_instance();
 	SoundCenter *SC = SoundCenter::get_instance();
 	ImageCenter *IC = ImageCenter::get_instance();
 	static ALLEGRO_SAMPLE_INSTANCE *backmusic = nullptr;
-	
+	SC->begin_frame();
 
 	int start_y = (DC->window_height - total_height) / 2;
 	int start_button_x = (DC->window_width - button_width) / 2;
@@ -310,13 +330,18 @@ bool Game::game_update() {
 					BGM_played = true;
 				}
 
+				if(DC->key_state[ALLEGRO_KEY_F] && !DC->prev_key_state[ALLEGRO_KEY_F]) {
+					speed_level = (speed_level + 1) % std::size(game_speeds);
+					debug_log("<Game> speed: x%d\n", game_speeds[speed_level]);
+				}
+
 				if(DC->key_state[ALLEGRO_KEY_P] && !DC->prev_key_state[ALLEGRO_KEY_P]) {
 					SC->toggle_playing(startmusic);
 					debug_log("<Game> state: change to PAUSE\n");
 					state = STATE::PAUSE;
 				}
 
-				if(DC->level->remain_monsters() == 0 && DC->monsters.size() == 0) {
+				if(DC->level->remain_monsters() == 0 && DC->monsters->empty()) {
 					debug_log("<Game> state: change to END\n");
 					state = STATE::END;
 				}
@@ -343,20 +368,59 @@ bool Game::game_update() {
 	}
 	// If the game is not paused, we should progress update.
 	if (state != STATE::PAUSE) {
-        DC->player->update();
-        DC->hero->update();
-		SC->update();
-        if (state != STATE::MAIN_MENU && state != STATE::ABOUT && state != STATE::ROLE_SELECT) {
-            DC->level->update();
-            OC->update();
-        }
-    }
+		// In a level, fast-forward runs several steps per frame, as many as fit in the step budget.
+		const int steps = (state == STATE::START) ? game_speeds[speed_level] : 1;
+		const double deadline = al_get_time() + step_budget / DC->FPS;
+		for(int k = 0; k < steps; ++k) {
+			if(k > 0) {
+				// Key presses and clicks of this frame are only seen by the first step.
+				memcpy(DC->prev_key_state, DC->key_state, sizeof(DC->key_state));
+				memcpy(DC->prev_mouse_state, DC->mouse_state, sizeof(DC->mouse_state));
+				if(al_get_time() > deadline) break;
+			}
+			game_step();
+		}
+	}
+	// The effective speed is only measured while playing a level. Entering the level (also after a pause or loading) or changing the speed starts a new window.
+	if(state != STATE::START) {
+		window_level = -1;
+	} else {
+		const double now = al_get_time();
+		const uint64_t tick = TimerCenter::get_instance()->get_tick();
+		if(window_level != speed_level) {
+			window_level = speed_level;
+			speed_measured = false;
+			window_start = now;
+			window_tick = tick;
+		} else if(now - window_start >= speed_window) {
+			effective_speed = (tick - window_tick) / ((now - window_start) * DC->FPS);
+			speed_measured = true;
+			window_start = now;
+			window_tick = tick;
+		}
+	}
 	// game_update is finished. The states of current frame will be previous states of the next frame.
 	memcpy(DC->prev_key_state, DC->key_state, sizeof(DC->key_state));
 	memcpy(DC->prev_mouse_state, DC->mouse_state, sizeof(DC->mouse_state));
 	return true;
 }
 
+/**
+ * @brief Advance the game by one fixed simulation step.
+ */
+void
+Game::game_step() {
+	DataCenter *DC = DataCenter::get_instance();
+	// Fire all timers due in this step (coin income, monster spawns, cooldowns, animations ... etc).
+	TimerCenter::get_instance()->update();
+	DC->hero->update();
+	if (state != STATE::MAIN_MENU && state != STATE::ABOUT && state != STATE::ROLE_SELECT) {
+		OperationCenter::get_instance()->update();
+	}
+	// Apply the hits, kills, leaks and coin gains of this step.
+	EventCenter::get_instance()->reduce();
+}
+
 /**
  * @brief Draw the whole game and objects.
  */
@@ -448,6 +512,17 @@ Game::game_draw() {
 			
 			DC->hero->draw();
 			OC->draw();
+			// fast-forward HUD: the selected speed, and the achieved speed if a full window at this speed shows the machine cannot keep up
+			const int speed = game_speeds[speed_level];
+			if(speed_measured && effective_speed < speed * 0.9) {
+				al_draw_textf(
+					FC->courier_new[FontSize::MEDIUM], al_map_rgb(255, 255, 255),
+					5, 5, ALLEGRO_ALIGN_LEFT, "x%d (x%.1f)", speed, effective_speed);
+			} else if(speed > 1) {
+				al_draw_textf(
+					FC->courier_new[FontSize::MEDIUM], al_map_rgb(255, 255, 255),
+					5, 5, ALLEGRO_ALIGN_LEFT, "x%d", speed);
+			}
 			break;
 		}
 
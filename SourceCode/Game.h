@@ -3,6 +3,7 @@
 
 #include <allegro5/allegro.h>
 #include "UI.h"
+#include <cstdint>
 
 /**
  * @brief Main class that runs the whole game.
@@ -18,6 +19,8 @@ public:
 	void game_init();
 	bool game_update();
 	void game_draw();
+private:
+	void game_step();
 private:
 	/**
 	 * @brief States of the game process in game_update.
@@ -39,6 +42,31 @@ private:
     ALLEGRO_BITMAP *role1_img;              // 角色1的按鈕圖片
     ALLEGRO_BITMAP *role2_img;              // 角色2的按鈕圖片
     ALLEGRO_BITMAP *role3_img;              // 角色3的按鈕圖片
+	/**
+	 * @var speed_level
+	 * @brief Index of the selected fast-forward speed in game_speeds.
+	 **
+	 * @var effective_speed
+	 * @brief Simulation steps per frame the game actually ran, measured over the last speed_window seconds.
+	 **
+	 * @var window_start
+	 * @brief Time (al_get_time) when the current measuring window started.
+	 **
+	 * @var window_tick
+	 * @brief Tick of TimerCenter when the current measuring window started.
+	 **
+	 * @var window_level
+	 * @brief speed_level the current measuring window runs at, or -1 if no window is open (outside STATE::START).
+	 **
+	 * @var speed_measured
+	 * @brief Whether effective_speed has been measured over a full window at the current speed_level since entering STATE::START.
+	 */
+	int speed_level = 0;
+	double effective_speed = 1;
+	double window_start = 0;
+	uint64_t window_tick = 0;
+	int window_level = -1;
+	bool speed_measured = false;
 private:
 	ALLEGRO_DISPLAY *display;
 	ALLEGRO_TIMER *timer;
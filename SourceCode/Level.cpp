@@ -1,18 +1,26 @@
 #include "Level.h"
 #include <string>
 #include "Utils.h"
-#include "monsters/Monster.h"
+#include "monsters/MonsterSystem.h"
 #include "data/DataCenter.h"
+#include "towers/TowerCoverage.h"
+#include "towers/EngagementScheduler.h"
+#include "PlacementMask.h"
+#include "data/EventCenter.h"
 #include <allegro5/allegro_primitives.h>
 #include "shapes/Point.h"
-#include "shapes/Rectangle.h"
+#include "shapes/Shape.h"
 #include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 using namespace std;
 
 // fixed settings
 namespace LevelSetting {
 	constexpr char level_path_format[] = "./assets/level/LEVEL%d.txt";
+	constexpr char wave_path_format[] = "./assets/level/WAVE%d.txt";
 	//! @brief Grid size for each level.
 	constexpr array<int, 4> grid_size = {
 		40, 40, 40, 40
@@ -25,7 +33,8 @@ Level::init() {
 	level = -1;
 	grid_w = -1;
 	grid_h = -1;
-	monster_spawn_counter = 0;
+	TimerCenter::get_instance()->cancel(spawn_timer);
+	spawn_timer = 0;
 }
 
 /**
@@ -35,7 +44,10 @@ Level::init() {
  *          * Total number of monsters.
  *          * Number of each different number of monsters. The order and number follows the definition of MonsterType.
  *          * Indefinite number of Point (x, y), represented in grid format.
+ *          * For an open map, -1 followed by the start and the goal Point instead. Monsters then find their own way, and placed towers may reroute them.
+ * @details Without a wave file, monsters spawn one at a time every monster_spawn_rate + 1 frames, all monsters of a type before the next type. If the wave file exists, the numbers of monsters of the level file are ignored and the waves are used instead.
  * @see level_path_format
+ * @see Level::_load_waves()
  * @see MonsterType
  */
 void
@@ -61,32 +73,219 @@ Level::load_level(int lvl) {
 	}
 
 	// read road path
+	open_map = false;
 	while(fscanf(f, "%d", &num) != EOF) {
+		if(num == -1 && road_path.empty()) {
+			open_map = true;
+			continue;
+		}
 		int w = num % grid_w;
 		int h = num / grid_h;
 		road_path.emplace_back(w, h);
 	}
+	if(open_map) {
+		GAME_ASSERT(road_path.size() == 2, "open map requires exactly a start and a goal.");
+		start_cell = grid_to_cell(road_path[0]);
+		flow.reset(grid_w, grid_h, grid_to_cell(road_path[1]));
+		_update_route();
+	}
+	_build_road_polyline();
+	// Coverage and engagement of towers depend on the largest hit box of monsters.
+	Monster::load_types();
+	DC->coverage->reset();
+	DC->placement->reset();
+	DC->engagement->reset();
+	EventCenter::get_instance()->reset_stats();
+
+	if(!_load_waves(lvl)) {
+		// The first monster spawns in the next frame, then one every monster_spawn_rate + 1 frames.
+		timeline.clear();
+		uint32_t tick = 1;
+		for(size_t i = 0; i < num_of_monsters.size(); ++i) {
+			for(int k = 0; k < num_of_monsters[i]; ++k) {
+				timeline.push_back({tick, static_cast<uint16_t>(i), 1});
+				tick += LevelSetting::monster_spawn_rate + 1;
+			}
+		}
+	}
+	TimerCenter *TC = TimerCenter::get_instance();
+	TC->cancel(spawn_timer);
+	spawn_timer = 0;
+	timeline_cursor = 0;
+	timeline_start = TC->get_tick();
+	if(!timeline.empty())
+		spawn_timer = TC->schedule(timeline.front().tick, [this]() { _spawn_due(); });
 	debug_log("<Level> load level %d.\n", lvl);
 }
 
 /**
- * @brief Updates monster_spawn_counter and create monster if needed.
-*/
+ * @brief Precompute the centers, cumulative arc lengths and segment directions of road_path.
+ */
 void
-Level::update() {
-	if(monster_spawn_counter) {
-		monster_spawn_counter--;
-		return;
+Level::_build_road_polyline() {
+	RoadPolyline &poly = road_polyline;
+	poly = RoadPolyline{};
+	for(size_t k = 0; k < road_path.size(); ++k) {
+		const Rectangle &region = grid_to_region(road_path[k]);
+		poly.x.emplace_back(region.center_x());
+		poly.y.emplace_back(region.center_y());
+		poly.s.emplace_back(0);
+		poly.ux.emplace_back(0);
+		poly.uy.emplace_back(0);
+		if(k == 0) continue;
+		const Vec2 &delta = Vec2{poly.x[k], poly.y[k]} - Vec2{poly.x[k - 1], poly.y[k - 1]};
+		double d = delta.length();
+		poly.s[k] = poly.s[k - 1] + d;
+		if(d > 0) {
+			poly.ux[k - 1] = delta.x / d;
+			poly.uy[k - 1] = delta.y / d;
+		}
 	}
+}
+
+/**
+ * @brief Set road_path to the current shortest route from the start to the goal of the open map.
+ */
+void
+Level::_update_route() {
+	road_path.clear();
+	if(!flow.is_reachable(start_cell)) return;
+	for(int c = start_cell; c != -1; c = flow.next(c))
+		road_path.emplace_back(cell_to_grid(c));
+}
+
+/**
+ * @brief Whether the grids under the region (e.g. a tower to be placed) could be blocked on an open map without trapping anything.
+ * @details The region could not be blocked if the start could not reach the goal anymore, or if any walking monster would be trapped or stand on a blocked grid. Nothing is changed.
+ * @return Whether the region can be blocked. Always true on a fixed road map.
+ * @see block_region()
+ */
+bool
+Level::can_block(const Rectangle &region) const {
+	if(!open_map) return true;
+	FlowField trial;
+	return _trial_block(region, trial);
+}
+
+/**
+ * @brief Block the grids under the region (e.g. a newly placed tower) on an open map and reroute the monsters.
+ * @details The placement is rejected if can_block() rejects the region.
+ * @return Whether the region is blocked. Always true on a fixed road map.
+ */
+bool
+Level::block_region(const Rectangle &region) {
+	if(!open_map) return true;
+	FlowField trial;
+	if(!_trial_block(region, trial)) return false;
+	flow = std::move(trial);
+	_update_route();
+	_build_road_polyline();
+	return true;
+}
+
+/**
+ * @brief Compute in trial the flow field with the grids under the region blocked, and check that nothing is trapped by it.
+ */
+bool
+Level::_trial_block(const Rectangle &region, FlowField &trial) const {
 	DataCenter *DC = DataCenter::get_instance();
+	const int &g = LevelSetting::grid_size[level];
+	vector<int> cells;
+	for(int y = max(0, static_cast<int>(floor(region.y1 / g))); y < min(grid_h, static_cast<int>(ceil(region.y2 / g))); ++y)
+		for(int x = max(0, static_cast<int>(floor(region.x1 / g))); x < min(grid_w, static_cast<int>(ceil(region.x2 / g))); ++x)
+			cells.emplace_back(y * grid_w + x);
+
+	trial = flow;
+	trial.block(cells);
+	if(!trial.is_reachable(start_cell)) return false;
+	const MonsterSystem *monsters = DC->monsters;
+	for(size_t i = 0; i < monsters->size(); ++i) {
+		if(monsters->reached_end(i)) continue;
+		if(!trial.is_reachable(pos_to_cell(monsters->x[i], monsters->y[i]))) return false;
+		if(!trial.is_reachable(monsters->wcell[i])) return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Get the grid index containing the pixel (x, y). Positions outside the field are clamped to the border grids.
+ */
+int
+Level::pos_to_cell(double x, double y) const {
+	const int &g = LevelSetting::grid_size[level];
+	int gx = min(grid_w - 1, max(0, static_cast<int>(floor(x / g))));
+	int gy = min(grid_h - 1, max(0, static_cast<int>(floor(y / g))));
+	return gy * grid_w + gx;
+}
+
+/**
+ * @brief Load the wave file of the level into timeline and num_of_monsters.
+ * @details The wave file is a list of commands. Everything after `#` in a line is a comment.
+ *          * `wave <delay>`: start a new wave `delay` frames after the previous wave started (or after the level is loaded).
+ *          * `group <type> <count> <delay> <interval> <burst>`: in the current wave, spawn `count` monsters of MonsterType `type`, starting `delay` frames after the wave starts, `burst` monsters at a time every `interval` frames.
+ * @details Groups of the same wave may overlap in time, so monsters of different groups interleave. Entries of the same tick keep the order of the file.
+ * @return False if the wave file does not exist.
+ * @see wave_path_format
+ */
+bool
+Level::_load_waves(int lvl) {
+	char buffer[50];
+	sprintf(buffer, LevelSetting::wave_path_format, lvl);
+	FILE *f = fopen(buffer, "r");
+	if(f == nullptr) return false;
+	timeline.clear();
+	num_of_monsters.assign(static_cast<size_t>(MonsterType::MONSTERTYPE_MAX), 0);
+	uint32_t wave_start = 0;
+	char key[16];
+	while(fscanf(f, "%15s", key) == 1) {
+		if(key[0] == '#') {
+			int c;
+			while((c = fgetc(f)) != EOF && c != '\n');
+		} else if(strcmp(key, "wave") == 0) {
+			int delay;
+			GAME_ASSERT(fscanf(f, "%d", &delay) == 1 && delay >= 0, "bad wave in %s.", buffer);
+			wave_start += delay;
+		} else if(strcmp(key, "group") == 0) {
+			int type, count, delay, interval, burst;
+			GAME_ASSERT(fscanf(f, "%d %d %d %d %d", &type, &count, &delay, &interval, &burst) == 5, "bad group in %s.", buffer);
+			GAME_ASSERT(0 <= type && type < static_cast<int>(MonsterType::MONSTERTYPE_MAX), "bad monster type %d in %s.", type, buffer);
+			GAME_ASSERT(count >= 0 && delay >= 0 && interval >= 0 && 0 < burst && burst <= UINT16_MAX, "bad group in %s.", buffer);
+			uint32_t tick = wave_start + delay;
+			for(int k = 0; k < count; k += burst) {
+				timeline.push_back({tick, static_cast<uint16_t>(type), static_cast<uint16_t>(min(burst, count - k))});
+				tick += interval;
+			}
+			num_of_monsters[type] += count;
+		} else {
+			GAME_ASSERT(false, "unknown command %s in %s.", key, buffer);
+		}
+	}
+	fclose(f);
+	stable_sort(timeline.begin(), timeline.end(), [](const SpawnEntry &a, const SpawnEntry &b) {
+		return a.tick < b.tick;
+	});
+	debug_log("<Level> load %zu spawns from %s.\n", timeline.size(), buffer);
+	return true;
+}
 
-	for(size_t i = 0; i < num_of_monsters.size(); ++i) {
-		if(num_of_monsters[i] == 0) continue;
-		DC->monsters.emplace_back(Monster::create_monster(static_cast<MonsterType>(i), DC->level->get_road_path()));
-		num_of_monsters[i]--;
-		break;
+/**
+ * @brief Spawn every entry of timeline that is due, then wait for the next entry. Called by spawn_timer.
+*/
+void
+Level::_spawn_due() {
+	DataCenter *DC = DataCenter::get_instance();
+	TimerCenter *TC = TimerCenter::get_instance();
+	const uint64_t now = TC->get_tick() - timeline_start;
+	for(; timeline_cursor < timeline.size() && timeline[timeline_cursor].tick <= now; ++timeline_cursor) {
+		const SpawnEntry &entry = timeline[timeline_cursor];
+		size_t first = DC->monsters->spawn(static_cast<MonsterType>(entry.type), entry.count);
+		for(size_t id = first; id < first + entry.count; ++id)
+			DC->engagement->schedule_monster(id);
+		num_of_monsters[entry.type] -= entry.count;
 	}
-	monster_spawn_counter = LevelSetting::monster_spawn_rate;
+	spawn_timer = 0;
+	if(timeline_cursor < timeline.size())
+		spawn_timer = TC->schedule(timeline[timeline_cursor].tick - now, [this]() { _spawn_due(); });
 }
 
 void
@@ -104,12 +303,20 @@ Level::draw() {
 bool
 Level::is_onroad(const Rectangle &region) {
 	for(const Point &grid : road_path) {
-		if(grid_to_region(grid).overlap(region))
+		if(checkOverlap(grid_to_region(grid), region))
 			return true;
 	}
 	return false;
 }
 
+/**
+ * @brief Side length of a grid of the current level.
+ */
+int
+Level::get_grid_size() const {
+	return LevelSetting::grid_size[level];
+}
+
 Rectangle
 Level::grid_to_region(const Point &grid) const {
 	int x1 = grid.x * LevelSetting::grid_size[level];
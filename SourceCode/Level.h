@@ -4,11 +4,37 @@
 #include <vector>
 #include <utility>
 #include <tuple>
+#include <cstdint>
+#include "./shapes/Point.h"
 #include "./shapes/Rectangle.h"
+#include "FlowField.h"
+#include "data/TimerCenter.h"
+
+/**
+ * @brief The road path as a polyline through the centers of its grids, parameterized by arc length.
+ * @details Point k is (x[k], y[k]) and lies at distance s[k] from the start along the road. Segment k goes from point k to point k+1 in unit direction (ux[k], uy[k]). The last point has a zero direction, so a distance d on the road always maps to the point `k` with the largest s[k] <= d, plus `d - s[k]` along segment k.
+ * @see Level::get_road_polyline()
+ */
+struct RoadPolyline {
+	std::vector<double> x, y;
+	std::vector<double> s;
+	std::vector<double> ux, uy;
+	double length() const { return s.empty() ? 0 : s.back(); }
+};
+
+/**
+ * @brief A batch of monsters of the same type spawning at the same tick.
+ * @see Level::load_level()
+ */
+struct SpawnEntry {
+	uint32_t tick;
+	uint16_t type;
+	uint16_t count;
+};
 
 /**
  * @brief The class manages data of each level.
- * @details The class could load level with designated input file and record. The level itself will decide when to create next monster.
+ * @details The class could load level with designated input file and record. The level itself will decide when to create next monster: all spawns of a level are sorted into a timeline, and a timer wakes the level only at the ticks something spawns.
  * @see DataCenter::level
  */
 class Level
@@ -17,22 +43,57 @@ public:
 	Level() {}
 	void init();
 	void load_level(int lvl);
-	void update();
 	void draw();
 	bool is_onroad(const Rectangle &region);
 	Rectangle grid_to_region(const Point &grid) const;
+	int get_grid_size() const;
 	const std::vector<Point> &get_road_path() const
 	{ return road_path; }
+	const RoadPolyline &get_road_polyline() const
+	{ return road_polyline; }
+	bool is_open_map() const { return open_map; }
+	const FlowField &get_flow_field() const { return flow; }
+	int get_start_cell() const { return start_cell; }
+	int grid_to_cell(const Point &grid) const
+	{ return static_cast<int>(grid.y) * grid_w + static_cast<int>(grid.x); }
+	Point cell_to_grid(int cell) const
+	{ return Point{cell % grid_w, cell / grid_w}; }
+	int pos_to_cell(double x, double y) const;
+	bool can_block(const Rectangle &region) const;
+	bool block_region(const Rectangle &region);
 	int remain_monsters() const {
 		int res = 0;
 		for(const int &i : num_of_monsters) res += i;
 		return res;
 	}
+private:
+	void _build_road_polyline();
+	void _update_route();
+	bool _trial_block(const Rectangle &region, FlowField &trial) const;
+	bool _load_waves(int lvl);
+	void _spawn_due();
 private:
 	/**
 	 * @brief Stores the monster's attack route, whose Point is represented in grid format.
 	 */
 	std::vector<Point> road_path;
+	/**
+	 * @brief The road path in pixels, shared by all monsters.
+	 */
+	RoadPolyline road_polyline;
+	/**
+	 * @brief Whether the level is an open map, where monsters walk on any grid toward the goal and towers may reroute them.
+	 * @details On an open map, road_path is the current shortest route from the start to the goal.
+	 */
+	bool open_map;
+	/**
+	 * @brief The grid monsters spawn at on an open map.
+	 */
+	int start_cell;
+	/**
+	 * @brief Routes from every grid to the goal on an open map.
+	 */
+	FlowField flow;
 	/**
 	 * @brief The index of current level.
 	 */
@@ -46,9 +107,21 @@ private:
 	 */
 	int grid_h;
 	/**
-	 * @brief Time remaining for the next monster to spawn.
+	 * @brief All spawns of the level sorted by tick (relative to the time the level is loaded).
+	 */
+	std::vector<SpawnEntry> timeline;
+	/**
+	 * @brief Index of the next entry of timeline to spawn.
+	 */
+	size_t timeline_cursor;
+	/**
+	 * @brief Tick of TimerCenter when the level is loaded.
+	 */
+	uint64_t timeline_start;
+	/**
+	 * @brief Timer firing at the tick of the next entry of timeline.
 	 */
-	int monster_spawn_counter;
+	TimerHandle spawn_timer = 0;
 	/**
 	 * @brief Number of each different type of monsters.
 	 */
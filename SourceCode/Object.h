@@ -1,9 +1,6 @@
 #ifndef OBJECT_H_INCLUDED
 #define OBJECT_H_INCLUDED
 
-#include "shapes/Shape.h"
-#include <memory>
-
 class Object
 {
 public:
@@ -12,8 +9,6 @@ public:
 public:
 	// pure function for drawing the object
 	virtual void draw() = 0;
-public:
-	std::unique_ptr<Shape> shape;
 };
 
 #endif
@@ -0,0 +1,87 @@
+#include "PlacementMask.h"
+#include "Level.h"
+#include "data/DataCenter.h"
+#include "towers/Tower.h"
+#include "towers/TowerSystem.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// fixed settings
+namespace PlacementSetting {
+	//! @brief Side length of a cell of the mask in pixels.
+	constexpr int cell_size = 4;
+};
+
+/**
+ * @brief Rebuild the mask from the road of the current level and the towers that already exist.
+ */
+void
+PlacementMask::reset() {
+	DataCenter *DC = DataCenter::get_instance();
+	// One more cell for regions touching the right and bottom edges of the game field.
+	cols = rows = DC->game_field_length / PlacementSetting::cell_size + 1;
+	words_per_row = (cols + 63) / 64;
+	bits.assign(rows * words_per_row, 0);
+	// On an open map, towers may be placed on the route to reroute monsters.
+	if(!DC->level->is_open_map()) {
+		for(const Point &grid : DC->level->get_road_path())
+			add_region(DC->level->grid_to_region(grid));
+	}
+	for(Tower *tower : *DC->towers)
+		add_region(tower->get_region());
+}
+
+/**
+ * @brief Mark every cell touched by the region as occupied.
+ */
+void
+PlacementMask::add_region(const Rectangle &region) {
+	int x1, y1, x2, y2;
+	if(!_cell_range(region, x1, y1, x2, y2)) return;
+	for(int y = y1; y <= y2; ++y) {
+		uint64_t *row = &bits[y * words_per_row];
+		for(int w = x1 / 64; w <= x2 / 64; ++w)
+			row[w] |= _word_mask(x1, x2, w);
+	}
+}
+
+/**
+ * @brief Check whether no cell touched by the region is occupied.
+ */
+bool
+PlacementMask::is_free(const Rectangle &region) const {
+	int x1, y1, x2, y2;
+	if(!_cell_range(region, x1, y1, x2, y2)) return true;
+	for(int y = y1; y <= y2; ++y) {
+		const uint64_t *row = &bits[y * words_per_row];
+		for(int w = x1 / 64; w <= x2 / 64; ++w) {
+			if(row[w] & _word_mask(x1, x2, w)) return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Get the cells touched by the region, clamped to the game field.
+ * @return false if the region is completely outside the game field.
+ */
+bool
+PlacementMask::_cell_range(const Rectangle &region, int &x1, int &y1, int &x2, int &y2) const {
+	x1 = max(0, static_cast<int>(floor(region.x1 / PlacementSetting::cell_size)));
+	y1 = max(0, static_cast<int>(floor(region.y1 / PlacementSetting::cell_size)));
+	x2 = min(cols - 1, static_cast<int>(floor(region.x2 / PlacementSetting::cell_size)));
+	y2 = min(rows - 1, static_cast<int>(floor(region.y2 / PlacementSetting::cell_size)));
+	return x1 <= x2 && y1 <= y2;
+}
+
+/**
+ * @brief Bits of the cells x1 to x2 (inclusive) that fall in the given word of a row.
+ */
+uint64_t
+PlacementMask::_word_mask(int x1, int x2, int word) {
+	int lo = max(x1, word * 64) - word * 64;
+	int hi = min(x2, word * 64 + 63) - word * 64;
+	return (~0ULL >> (63 - (hi - lo))) << lo;
+}
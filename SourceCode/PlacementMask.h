@@ -0,0 +1,43 @@
+#ifndef PLACEMENTMASK_H_INCLUDED
+#define PLACEMENTMASK_H_INCLUDED
+
+#include "./shapes/Rectangle.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Bit-packed occupancy grid of the game field, used to check whether a tower can be placed.
+ * @details The game field is divided into small square cells, and each row of cells is packed into 64-bit words. A cell is occupied if it is touched by a road grid or the region of a placed tower. A footprint is legal if none of the cells it touches is occupied, which only takes a few word-wide AND operations per row.
+ * Regions are rasterized conservatively: a footprint is rejected if it shares a cell with an occupied region, even if the two rectangles themselves do not overlap.
+ * Cells outside the game field are always free.
+ */
+class PlacementMask
+{
+public:
+	PlacementMask() {}
+	void reset();
+	void add_region(const Rectangle &region);
+	bool is_free(const Rectangle &region) const;
+private:
+	bool _cell_range(const Rectangle &region, int &x1, int &y1, int &x2, int &y2) const;
+	static uint64_t _word_mask(int x1, int x2, int word);
+private:
+	/**
+	 * @var cols
+	 * @brief Number of cells in x-direction.
+	 **
+	 * @var rows
+	 * @brief Number of cells in y-direction.
+	 **
+	 * @var words_per_row
+	 * @brief Number of 64-bit words storing a row of cells.
+	 **
+	 * @var bits
+	 * @brief Occupancy bits. Cell (x, y) is bit `x % 64` of `bits[y * words_per_row + x / 64]`.
+	 */
+	int cols = 0, rows = 0;
+	int words_per_row = 0;
+	std::vector<uint64_t> bits;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Player.h"
+#include "data/EventCenter.h"
 
 // fixed settings
 namespace PlayerSetting {
@@ -8,17 +9,15 @@ namespace PlayerSetting {
 	constexpr int coin_increase = 5;
 };
 
+/**
+ * @details The player earns coin_increase coins every coin_freq + 1 frames. The coins are added by EventCenter at the end of the frame.
+ */
 Player::Player() : HP(PlayerSetting::init_HP), coin(PlayerSetting::init_coin) {
 	this->coin_freq = PlayerSetting::coin_freq;
 	this->coin_increase = PlayerSetting::coin_increase;
-	coin_counter = PlayerSetting::coin_freq;
+	coin_timer = TimerCenter::get_instance()->schedule(coin_freq + 1, [this]() { EventCenter::get_instance()->emit(EventType::COIN, 0, 0, coin_increase); }, coin_freq + 1);
 }
 
-void
-Player::update() {
-	if(coin_counter) --coin_counter;
-	else {
-		coin += coin_increase;
-		coin_counter = coin_freq;
-	}
+Player::~Player() {
+	TimerCenter::get_instance()->cancel(coin_timer);
 }
@@ -1,17 +1,19 @@
 #ifndef PLAYER_H_INCLUDED
 #define PLAYER_H_INCLUDED
 
+#include "data/TimerCenter.h"
+
 class Player
 {
 public:
 	Player();
-	void update();
+	~Player();
 	int HP;
 	int coin;
 private:
 	int coin_freq;
 	int coin_increase;
-	int coin_counter;
+	TimerHandle coin_timer;
 };
 
 #endif
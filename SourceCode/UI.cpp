@@ -4,12 +4,17 @@
 #include "data/ImageCenter.h"
 #include "data/FontCenter.h"
 #include <algorithm>
+#include <string>
 #include <allegro5/allegro_primitives.h>
 #include <allegro5/allegro_ttf.h>
 #include "shapes/Point.h"
-#include "shapes/Rectangle.h"
+#include "shapes/Shape.h"
 #include "Player.h"
 #include "towers/Tower.h"
+#include "towers/TowerSystem.h"
+#include "towers/TowerCoverage.h"
+#include "towers/EngagementScheduler.h"
+#include "PlacementMask.h"
 #include "Level.h"
 
 // fixed settings
@@ -18,6 +23,26 @@ constexpr int love_img_padding = 5;
 constexpr int tower_img_left_padding = 30;
 constexpr int tower_img_top_padding = 30;
 
+/**
+ * @brief The region a tower of the type would occupy if it is placed at p.
+ */
+static Rectangle place_region(TowerType type, const Point &p) {
+	ALLEGRO_BITMAP *bitmap = Tower::get_bitmap(type);
+	int w = al_get_bitmap_width(bitmap);
+	int h = al_get_bitmap_height(bitmap);
+	return Rectangle{p.x - w / 2, p.y - h / 2, p.x + w / 2, p.y + h / 2};
+}
+
+/**
+ * @brief Whether a tower of the type could be placed at p: it cannot be placed on the road or intersect with other towers, and on an open map it cannot block the route of monsters.
+ * @details Used by both the placement and its preview, so the preview is green exactly when a click would place the tower.
+ */
+static bool can_place(TowerType type, const Point &p) {
+	DataCenter *DC = DataCenter::get_instance();
+	const Rectangle &region = place_region(type, p);
+	return DC->placement->is_free(region) && DC->level->can_block(region);
+}
+
 void
 UI::init() {
 	DataCenter *DC = DataCenter::get_instance();
@@ -28,7 +53,8 @@ UI::init() {
 	int max_height = 0;
 	// arrange tower shop
 	for(size_t i = 0; i < (size_t)(TowerType::TOWERTYPE_MAX); ++i) {
-		ALLEGRO_BITMAP *bitmap = IC->get(TowerSetting::tower_menu_img_path[i]);
+		const TowerInfo &info = Tower::get_info(static_cast<TowerType>(i));
+		ALLEGRO_BITMAP *bitmap = IC->get(std::string{info.menu_img_path});
 		int w = al_get_bitmap_width(bitmap);
 		int h = al_get_bitmap_height(bitmap);
 		if(tl_x + w > DC->window_width) {
@@ -36,7 +62,7 @@ UI::init() {
 			tl_y += max_height + tower_img_top_padding;
 			max_height = 0;
 		}
-		tower_items.emplace_back(bitmap, Point{tl_x, tl_y}, TowerSetting::tower_price[i]);
+		tower_items.emplace_back(bitmap, Point{tl_x, tl_y}, info.price);
 		tl_x += w + tower_img_left_padding;
 		max_height = std::max(max_height, h);
 	}
@@ -57,7 +83,7 @@ UI::update() {
 				int w = al_get_bitmap_width(bitmap);
 				int h = al_get_bitmap_height(bitmap);
 				// hover on a shop tower item
-				if(mouse.overlap(Rectangle{p.x, p.y, p.x+w, p.y+h})) {
+				if(checkOverlap(mouse, Rectangle{p.x, p.y, p.x+w, p.y+h})) {
 					on_item = i;
 					debug_log("<UI> state: change to HOVER\n");
 					state = STATE::HOVER;
@@ -69,7 +95,7 @@ UI::update() {
 			auto &[bitmap, p, price] = tower_items[on_item];
 			int w = al_get_bitmap_width(bitmap);
 			int h = al_get_bitmap_height(bitmap);
-			if(!mouse.overlap(Rectangle{p.x, p.y, p.x+w, p.y+h})) {
+			if(!checkOverlap(mouse, Rectangle{p.x, p.y, p.x+w, p.y+h})) {
 				on_item = -1;
 				debug_log("<UI> state: change to HALT\n");
 				state = STATE::HALT;
@@ -101,21 +127,15 @@ UI::update() {
 			break;
 		} case STATE::PLACE: {
 			// check placement legality
-			ALLEGRO_BITMAP *bitmap = Tower::get_bitmap(static_cast<TowerType>(on_item));
-			int w = al_get_bitmap_width(bitmap);
-			int h = al_get_bitmap_height(bitmap);
-			Rectangle place_region{mouse.x - w / 2, mouse.y - h / 2, DC->mouse.x + w / 2, DC->mouse.y + h / 2};
-			bool place = true;
-			// tower cannot be placed on the road
-			place &= (!DC->level->is_onroad(place_region));
-			// tower cannot intersect with other towers
-			for(Tower *tower : DC->towers) {
-				place &= (!place_region.overlap(tower->get_region()));
-			}
-			if(!place) {
+			if(!can_place(static_cast<TowerType>(on_item), mouse)) {
 				debug_log("<UI> Tower place failed.\n");
 			} else {
-				DC->towers.emplace_back(Tower::create_tower(static_cast<TowerType>(on_item), mouse));
+				// on an open map, monsters are rerouted around the tower
+				DC->level->block_region(place_region(static_cast<TowerType>(on_item), mouse));
+				Tower *tower = DC->towers->add(static_cast<TowerType>(on_item), mouse);
+				DC->coverage->add_tower(tower);
+				DC->engagement->add_tower(tower);
+				DC->placement->add_region(tower->get_region());
 				DC->player->coin -= std::get<2>(tower_items[on_item]);
 			}
 			debug_log("<UI> state: change to HALT\n");
@@ -180,17 +200,21 @@ UI::draw() {
 			if(selected_tower == nullptr) {
 				selected_tower = Tower::create_tower(static_cast<TowerType>(on_item), mouse);
 			} else {
-				selected_tower->shape->update_center_x(mouse.x);
-				selected_tower->shape->update_center_y(mouse.y);
+				selected_tower->shape.update_center_x(mouse.x);
+				selected_tower->shape.update_center_y(mouse.y);
 			}
 		}
 		case STATE::PLACE: {
 			// If we select a tower from menu, we need to preview where the tower will be built and its attack range.
+			// The preview is green if the tower can be placed here, otherwise red.
 			ALLEGRO_BITMAP *bitmap = Tower::get_bitmap(static_cast<TowerType>(on_item));
-			al_draw_filled_circle(mouse.x, mouse.y, selected_tower->attack_range(), al_map_rgba(255, 0, 0, 32));
+			bool place = can_place(static_cast<TowerType>(on_item), mouse);
+			ALLEGRO_COLOR range_color = place ? al_map_rgba(0, 255, 0, 32) : al_map_rgba(255, 0, 0, 32);
+			ALLEGRO_COLOR tint = place ? al_map_rgba(160, 255, 160, 255) : al_map_rgba(255, 160, 160, 255);
+			al_draw_filled_circle(mouse.x, mouse.y, selected_tower->attack_range(), range_color);
 			int w = al_get_bitmap_width(bitmap);
 			int h = al_get_bitmap_height(bitmap);
-			al_draw_bitmap(bitmap, mouse.x - w / 2, mouse.y - h / 2, 0);
+			al_draw_tinted_bitmap(bitmap, tint, mouse.x - w / 2, mouse.y - h / 2, 0);
 			break;
 		}
 	}
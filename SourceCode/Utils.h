@@ -2,6 +2,8 @@
 #define GAME_ASSERT_H_INCLUDED
 
 #include <cstdio>
+#include <vector>
+#include <utility>
 #include <allegro5/system.h>
 
 /**
@@ -20,6 +22,19 @@
 	} \
 }
 
+/**
+ * @brief Remove the elements whose mark is set from an array, keeping the order of the other elements.
+ * @details Arrays of a structure-of-arrays container share the same marks, so calling this function on every array removes the marked entities in one linear pass per array.
+ */
+template<typename T>
+void compact_marked(std::vector<T> &v, const std::vector<char> &marked) {
+	size_t w = 0;
+	for(size_t i = 0; i < v.size(); ++i) {
+		if(!marked[i]) v[w++] = std::move(v[i]);
+	}
+	v.resize(w);
+}
+
 #ifdef DEBUG
 	#define debug_log(...) printf(__VA_ARGS__)
 #else
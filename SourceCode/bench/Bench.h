@@ -0,0 +1,46 @@
+#ifndef BENCH_H_INCLUDED
+#define BENCH_H_INCLUDED
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+
+/**
+ * @file Bench.h
+ * @brief Helpers shared by the microbenchmarks of `make bench`.
+ * @details Every benchmark is a small program linked with the objects of the game. It prints one line per measurement and does not check anything.
+ */
+
+/**
+ * @brief Results of benchmarked computations are stored here, so that the compiler cannot drop them.
+ */
+inline volatile size_t bench_sink = 0;
+
+inline void bench_keep(size_t v) { bench_sink = v; }
+
+/**
+ * @brief Run setup() and then f() rounds times, and return the fastest run of f() in milliseconds.
+ * @details setup() is not timed, so every run could start from the same state. The fastest run is the one least disturbed by other processes.
+ */
+template<typename S, typename F>
+double bench_ms(int rounds, S &&setup, F &&f) {
+	double best = -1;
+	for(int k = 0; k < rounds; ++k) {
+		setup();
+		const auto start = std::chrono::steady_clock::now();
+		f();
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if(best < 0 || ms < best) best = ms;
+	}
+	return best;
+}
+
+/**
+ * @brief Print a measurement as `<name> <ms> ms`, with the speedup over a baseline measurement if base_ms is positive.
+ */
+inline void bench_report(const char *name, double ms, double base_ms = 0) {
+	if(base_ms > 0) printf("%-40s %10.4f ms  (x%.1f)\n", name, ms, base_ms / ms);
+	else printf("%-40s %10.4f ms\n", name, ms);
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include "Bench.h"
+#include "../shapes/SpatialGrid.h"
+#include "../shapes/Shape.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+
+// fixed settings
+namespace BroadphaseBenchSetting {
+	constexpr double field_length = 600;
+	constexpr double cell_size = 40;
+	constexpr double half_extent = 16;
+	constexpr double projectile_r = 4;
+	// one projectile for every projectile_every monsters
+	constexpr size_t projectile_every = 10;
+	constexpr size_t monster_counts[] = {1000, 10000, 100000};
+	// The pair test grows with n * m, so it only runs for this many projectiles and is scaled up.
+	constexpr size_t max_pair_projectiles = 1000;
+}
+
+/**
+ * @brief Monster hit boxes against projectiles on the 600x600 field at 1k, 10k and 100k monsters: the uniform grid (rebuilt every tick) against testing every pair.
+ * @details Monsters and projectiles are spread uniformly over the field, with one projectile for every 10 monsters. A grid tick is one SpatialGrid::build() of all hit boxes plus one query per projectile. Both count the same overlapping pairs.
+ * At 100k monsters, testing every pair takes seconds, so it is timed on the first max_pair_projectiles projectiles and scaled to all of them.
+ */
+int main() {
+	using namespace BroadphaseBenchSetting;
+	mt19937 rng(2024);
+	uniform_real_distribution<double> pos(0, field_length);
+	for(size_t n : monster_counts) {
+		const size_t m = n / projectile_every;
+		vector<double> x(n), y(n), hw(n, half_extent), hh(n, half_extent);
+		vector<Rectangle> boxes(n);
+		for(size_t i = 0; i < n; ++i) {
+			x[i] = pos(rng), y[i] = pos(rng);
+			boxes[i] = Rectangle{x[i] - hw[i], y[i] - hh[i], x[i] + hw[i], y[i] + hh[i]};
+		}
+		vector<Circle> projectiles(m);
+		for(Circle &c : projectiles)
+			c = Circle{pos(rng), pos(rng), projectile_r};
+		const size_t sampled = min(m, max_pair_projectiles);
+		const int rounds = n >= 10000 ? 2 : 20;
+
+		size_t pairs_all = 0, pairs_grid = 0;
+		const double all_ms = bench_ms(rounds, []() {}, [&]() {
+			pairs_all = 0;
+			for(size_t k = 0; k < sampled; ++k)
+				for(const Rectangle &r : boxes)
+					pairs_all += checkOverlap(projectiles[k], r);
+			bench_keep(pairs_all);
+		}) * m / sampled;
+		SpatialGrid grid;
+		const double grid_ms = bench_ms(rounds * 10, []() {}, [&]() {
+			pairs_grid = 0;
+			grid.reset(field_length, cell_size);
+			grid.build(n, x.data(), y.data(), hw.data(), hh.data());
+			for(const Circle &c : projectiles)
+				grid.query_overlap(c, [&](size_t) { ++pairs_grid; });
+			bench_keep(pairs_grid);
+		});
+
+		printf("%zu monsters, %zu projectiles, %zu overlapping pairs\n", n, m, pairs_grid);
+		if(sampled == m && pairs_all != pairs_grid) printf("  MISMATCH: %zu pairs by testing all pairs\n", pairs_all);
+		bench_report(sampled == m ? "  all pairs" : "  all pairs (scaled)", all_ms);
+		bench_report("  uniform grid (build + queries)", grid_ms, all_ms);
+	}
+	return 0;
+}
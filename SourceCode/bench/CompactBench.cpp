@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include "../projectiles/ProjectileSystem.h"
+#include <vector>
+#include <random>
+#include <memory>
+
+using namespace std;
+
+// fixed settings
+namespace CompactBenchSetting {
+	constexpr size_t entity_count = 10000;
+	// one entity of every dead_every is removed
+	constexpr size_t dead_every = 3;
+	constexpr int rounds = 50;
+}
+
+/**
+ * @brief A bullet as it was stored before ProjectileSystem: one heap object per bullet, with its hit circle behind another pointer.
+ */
+struct OldBullet {
+	unique_ptr<Circle> shape;
+	double vx, vy;
+	double fly_dist;
+	int dmg;
+	void *bitmap;
+};
+
+/**
+ * @brief Removal of dead entities at 10k entities: ProjectileSystem::compact() against the erase loop it replaced.
+ * @details Both remove the same entities, chosen at random with the same seed. The erase loop deletes each dead bullet and erases it from the middle of the vector, which shifts all the bullets after it.
+ */
+int main() {
+	using namespace CompactBenchSetting;
+	mt19937 rng(2024);
+	vector<char> dead(entity_count);
+	for(char &d : dead) d = (rng() % dead_every == 0);
+
+	ProjectileSystem projectiles;
+	auto fill_projectiles = [&]() {
+		projectiles.clear();
+		for(size_t i = 0; i < entity_count; ++i) {
+			projectiles.x.emplace_back(i); projectiles.y.emplace_back(i);
+			projectiles.px.emplace_back(i); projectiles.py.emplace_back(i);
+			projectiles.vx.emplace_back(1); projectiles.vy.emplace_back(1);
+			projectiles.speed.emplace_back(1);
+			projectiles.remain.emplace_back(100);
+			projectiles.r.emplace_back(4);
+			projectiles.dmg.emplace_back(5);
+			projectiles.effect.emplace_back(-1);
+			projectiles.splash.emplace_back(0);
+			projectiles.chain.emplace_back(0);
+			projectiles.sprite.emplace_back(0);
+			projectiles.owner_kind.emplace_back(ProjectileOwner::TOWER);
+			projectiles.dead.emplace_back(dead[i]);
+		}
+	};
+	const double compact_ms = bench_ms(rounds, fill_projectiles, [&]() {
+		projectiles.compact();
+		bench_keep(projectiles.size());
+	});
+
+	vector<OldBullet*> bullets;
+	auto fill_bullets = [&]() {
+		for(OldBullet *bullet : bullets)
+			delete bullet;
+		bullets.clear();
+		for(size_t i = 0; i < entity_count; ++i)
+			bullets.emplace_back(new OldBullet{make_unique<Circle>(i, i, 4), 1, 1, dead[i] ? 0. : 100., 5, nullptr});
+	};
+	const double erase_ms = bench_ms(rounds, fill_bullets, [&]() {
+		for(size_t i = 0; i < bullets.size(); ++i) {
+			if(bullets[i]->fly_dist <= 0) {
+				delete bullets[i];
+				bullets.erase(bullets.begin() + i);
+				--i;
+			}
+		}
+		bench_keep(bullets.size());
+	});
+	for(OldBullet *bullet : bullets)
+		delete bullet;
+
+	printf("removing 1/%zu of %zu entities\n", dead_every, entity_count);
+	bench_report("erase loop (vector<Bullet*>)", erase_ms);
+	bench_report("mark and compact (ProjectileSystem)", compact_ms, erase_ms);
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "Bench.h"
+#include "../shapes/Shape.h"
+#include "../shapes/OverlapBatch.h"
+#include <vector>
+#include <random>
+
+using namespace std;
+
+// fixed settings
+namespace OverlapBenchSetting {
+	constexpr double field_length = 600;
+	constexpr double half_extent = 16;
+	constexpr double projectile_r = 4;
+	constexpr size_t monster_count = 10000;
+	constexpr size_t projectile_count = 1000;
+	constexpr int rounds = 20;
+	constexpr OverlapISA isas[] = {OverlapISA::SCALAR, OverlapISA::SSE2, OverlapISA::AVX2};
+	constexpr const char *isa_names[] = {"  checkOverlapBatch (scalar)", "  checkOverlapBatch (SSE2)", "  checkOverlapBatch (AVX2)"};
+}
+
+/**
+ * @brief Projectiles against every monster hit box at 10k monsters: checkOverlap() on each box against each kernel of checkOverlapBatch(), selected by set_overlap_isa().
+ * @details Hit boxes are stored as MonsterSystem stores them, and the per-box loop builds a Rectangle for each box as the systems did. All of them count the same overlapping pairs. Kernels the CPU does not support are skipped.
+ */
+int main() {
+	using namespace OverlapBenchSetting;
+	mt19937 rng(2024);
+	uniform_real_distribution<double> pos(0, field_length);
+	vector<double> x(monster_count), y(monster_count), hw(monster_count, half_extent), hh(monster_count, half_extent);
+	for(size_t i = 0; i < monster_count; ++i)
+		x[i] = pos(rng), y[i] = pos(rng);
+	vector<Circle> projectiles(projectile_count);
+	for(Circle &c : projectiles)
+		c = Circle{pos(rng), pos(rng), projectile_r};
+	const BoxBatch boxes{x.data(), y.data(), hw.data(), hh.data()};
+
+	size_t pairs_loop = 0;
+	const double loop_ms = bench_ms(rounds, []() {}, [&]() {
+		pairs_loop = 0;
+		for(const Circle &c : projectiles)
+			for(size_t i = 0; i < monster_count; ++i)
+				pairs_loop += checkOverlap(c, Rectangle{x[i] - hw[i], y[i] - hh[i], x[i] + hw[i], y[i] + hh[i]});
+		bench_keep(pairs_loop);
+	});
+	printf("%zu projectiles against %zu monsters, %zu overlapping pairs\n", projectile_count, monster_count, pairs_loop);
+	bench_report("  checkOverlap on each box", loop_ms);
+
+	vector<uint64_t> mask(overlap_mask_words(monster_count));
+	const OverlapISA best = overlap_isa();
+	for(size_t k = 0; k < size(isas); ++k) {
+		if(set_overlap_isa(isas[k]) != isas[k]) {
+			printf("%-40s not supported by this CPU\n", isa_names[k]);
+			continue;
+		}
+		size_t pairs = 0;
+		const double ms = bench_ms(rounds, []() {}, [&]() {
+			pairs = 0;
+			for(const Circle &c : projectiles)
+				pairs += checkOverlapBatch(c, boxes, monster_count, mask.data());
+			bench_keep(pairs);
+		});
+		if(pairs != pairs_loop) printf("  MISMATCH: %zu pairs\n", pairs);
+		bench_report(isa_names[k], ms, loop_ms);
+	}
+	set_overlap_isa(best);
+	return 0;
+}
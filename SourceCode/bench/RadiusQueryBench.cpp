@@ -0,0 +1,96 @@
+#include "Bench.h"
+#include "../shapes/SpatialGrid.h"
+#include "../shapes/Shape.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+// fixed settings
+namespace RadiusQueryBenchSetting {
+	constexpr double field_length = 600;
+	constexpr double cell_size = 40;
+	constexpr double half_extent = 16;
+	constexpr size_t monster_count = 10000;
+	constexpr size_t query_count = 1000;
+	// as a splash projectile and a chain of ProjectileSystem
+	constexpr double splash_radius = 60;
+	constexpr double chain_range = 100;
+	constexpr size_t chain_k = 8;
+	constexpr int rounds = 20;
+}
+
+/**
+ * @brief Radius and k-nearest queries at 10k monsters, as splash and chain hits use them: the uniform grid against scanning every monster.
+ * @details The grid is built once, as it is once per tick in the game, and is not timed. Both radius queries find the same monsters, and both nearest queries find the same monsters in the same order, with ties broken by index.
+ */
+int main() {
+	using namespace RadiusQueryBenchSetting;
+	mt19937 rng(2024);
+	uniform_real_distribution<double> pos(0, field_length);
+	vector<double> x(monster_count), y(monster_count), hw(monster_count, half_extent), hh(monster_count, half_extent);
+	for(size_t i = 0; i < monster_count; ++i)
+		x[i] = pos(rng), y[i] = pos(rng);
+	vector<pair<double, double>> points(query_count);
+	for(auto &[px, py] : points)
+		px = pos(rng), py = pos(rng);
+	SpatialGrid grid;
+	grid.reset(field_length, cell_size);
+	grid.build(monster_count, x.data(), y.data(), hw.data(), hh.data());
+
+	size_t found_scan = 0, found_grid = 0;
+	const double scan_ms = bench_ms(rounds, []() {}, [&]() {
+		found_scan = 0;
+		for(const auto &[px, py] : points) {
+			const Circle c{px, py, splash_radius};
+			for(size_t i = 0; i < monster_count; ++i)
+				found_scan += checkOverlap(c, Rectangle{x[i] - hw[i], y[i] - hh[i], x[i] + hw[i], y[i] + hh[i]});
+		}
+		bench_keep(found_scan);
+	});
+	const double grid_ms = bench_ms(rounds, []() {}, [&]() {
+		found_grid = 0;
+		for(const auto &[px, py] : points)
+			grid.query_overlap(Circle{px, py, splash_radius}, [&](size_t) { ++found_grid; });
+		bench_keep(found_grid);
+	});
+	printf("%zu radius queries of r=%.0f at %zu monsters, %zu found\n", query_count, splash_radius, monster_count, found_grid);
+	if(found_scan != found_grid) printf("  MISMATCH: %zu found by scanning\n", found_scan);
+	bench_report("  scan every monster", scan_ms);
+	bench_report("  uniform grid", grid_ms, scan_ms);
+
+	pair<double, size_t> out[chain_k];
+	size_t order_scan = 0, order_grid = 0;
+	vector<pair<double, size_t>> candidates;
+	const double nearest_scan_ms = bench_ms(rounds, []() {}, [&]() {
+		order_scan = 0;
+		for(const auto &[px, py] : points) {
+			candidates.clear();
+			for(size_t i = 0; i < monster_count; ++i) {
+				const double dx = x[i] - px, dy = y[i] - py;
+				if(dx * dx + dy * dy <= chain_range * chain_range) candidates.emplace_back(dx * dx + dy * dy, i);
+			}
+			const size_t k = min(chain_k, candidates.size());
+			partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+			for(size_t t = 0; t < k; ++t)
+				order_scan = order_scan * 31 + candidates[t].second;
+		}
+		bench_keep(order_scan);
+	});
+	const double nearest_grid_ms = bench_ms(rounds, []() {}, [&]() {
+		order_grid = 0;
+		for(const auto &[px, py] : points) {
+			const size_t k = grid.nearest(px, py, chain_range, chain_k, out, [](size_t) { return false; });
+			for(size_t t = 0; t < k; ++t)
+				order_grid = order_grid * 31 + out[t].second;
+		}
+		bench_keep(order_grid);
+	});
+	printf("%zu queries of the %zu nearest within %.0f at %zu monsters\n", query_count, chain_k, chain_range, monster_count);
+	if(order_scan != order_grid) printf("  MISMATCH: scanning finds other monsters\n");
+	bench_report("  scan every monster + partial_sort", nearest_scan_ms);
+	bench_report("  uniform grid", nearest_grid_ms, nearest_scan_ms);
+	return 0;
+}
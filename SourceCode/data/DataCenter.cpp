@@ -3,10 +3,13 @@
 #include "../Level.h"
 #include "../Player.h"
 #include "../hero/Hero.h"
-#include "../monsters/Monster.h"
-#include "../towers/Tower.h"
-#include "../towers/Bullet.h"
-#include "../hero/Rocket.h"
+#include "../monsters/MonsterSystem.h"
+#include "../towers/TowerSystem.h"
+#include "../towers/TowerCoverage.h"
+#include "../towers/EngagementScheduler.h"
+#include "../PlacementMask.h"
+#include "../projectiles/ProjectileSystem.h"
+#include "../projectiles/BeamSystem.h"
 
 // fixed settings
 namespace DataSetting {
@@ -29,22 +32,24 @@ DataCenter::DataCenter() {
 	player = new Player();
 	level = new Level();
 	hero = new Hero();
+	monsters = new MonsterSystem();
+	projectiles = new ProjectileSystem();
+	beams = new BeamSystem();
+	towers = new TowerSystem();
+	coverage = new TowerCoverage();
+	engagement = new EngagementScheduler();
+	placement = new PlacementMask();
 }
 
 DataCenter::~DataCenter() {
 	delete player;
 	delete level;
 	delete hero;
-	for(Monster *&m : monsters) {
-		delete m;
-	}
-	for(Tower *&t : towers) {
-		delete t;
-	}
-	for(Bullet *&b : towerBullets) {
-		delete b;
-	}
-	for(Rocket *&r : rockets) { 
-        delete r;
-    }
+	delete monsters;
+	delete towers;
+	delete projectiles;
+	delete beams;
+	delete coverage;
+	delete engagement;
+	delete placement;
 }
@@ -9,13 +9,15 @@
 
 class Player;
 class Level;
-class Monster;
-class Tower;
-class Bullet;
+class MonsterSystem;
+class TowerSystem;
+class ProjectileSystem;
+class BeamSystem;
+class TowerCoverage;
+class PlacementMask;
+class EngagementScheduler;
 class Hero;
 
-class Rocket;
-
 /**
  * @brief Stores generic global data and relatively small data structures.
  * @details The globally used data such as FPS (frames per second), windows size, game region, and states of input devices (mouse and keyboard).
@@ -83,22 +85,40 @@ public:
 
 	Hero *hero;
 	/**
-	 * @brief Raw list of Monster objects.
-	 * @see Monster
+	 * @brief All walking monsters, stored in structure-of-arrays layout.
+	 * @see MonsterSystem
 	 */
-	std::vector<Monster*> monsters;
+	MonsterSystem *monsters;
 	/**
-	 * @brief Raw list of Tower objects.
-	 * @see Tower
+	 * @brief All placed towers, bucketed by type.
+	 * @see TowerSystem
 	 */
-	std::vector<Tower*> towers;
+	TowerSystem *towers;
 	/**
-	 * @brief Raw list of Bullet objects.
-	 * @see Bullet
+	 * @brief Road cells covered by each tower and monsters standing on each road cell.
+	 * @see TowerCoverage
 	 */
-	std::vector<Bullet*> towerBullets;
-
-	std::vector<Rocket*> rockets;
+	TowerCoverage *coverage;
+	/**
+	 * @brief Predicted times when monsters enter and leave the range of each tower.
+	 * @see EngagementScheduler
+	 */
+	EngagementScheduler *engagement;
+	/**
+	 * @brief Cells of the game field occupied by the road or towers, used to check tower placement.
+	 * @see PlacementMask
+	 */
+	PlacementMask *placement;
+	/**
+	 * @brief All flying tower bullets and hero rockets, stored in pooled structure-of-arrays layout.
+	 * @see ProjectileSystem
+	 */
+	ProjectileSystem *projectiles;
+	/**
+	 * @brief Beams of hitscan tower attacks, only kept to be drawn for a few frames.
+	 * @see BeamSystem
+	 */
+	BeamSystem *beams;
 private:
 	DataCenter();
 };
@@ -0,0 +1,133 @@
+#include "EventCenter.h"
+#include "DataCenter.h"
+#include "JobCenter.h"
+#include "ScriptCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../Player.h"
+#include "../Utils.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * @brief Make sure every thread of JobCenter has a buffer. Must not be called while a graph is running.
+ */
+void
+EventCenter::set_thread_count(size_t n) {
+	if(buffers.size() < n) buffers.resize(n);
+}
+
+void
+EventCenter::emit(EventType type, size_t key, size_t monster, int value) {
+	buffers[JobCenter::get_thread_index()].push_back(GameEvent{type, key, monster, value});
+}
+
+/**
+ * @brief Apply all events of this frame, then remove the monsters killed or leaked.
+ * @details Events are sorted by type, then by key, monster and value, so that equal keys from different threads are applied in the same order with any number of threads. Events equal in all four are interchangeable. They are applied in this order:
+ * @details * DAMAGE and POISON reduce the HP of monsters.
+ * @details * CONTACT removes monsters touching the hero, and the player loses 1 HP each.
+ * @details * Every monster damaged or arrived is then checked in the order of monsters. A monster without HP is killed (KILL), otherwise an arrived monster leaks (LEAK).
+ * @details * EFFECT puts status effects on the monsters still alive.
+ * @details * COIN adds coins to the player.
+ * @details Scripts waiting for the applied events are resumed before the removed monsters are gone, so they still find the monster of every event.
+ */
+void
+EventCenter::reduce() {
+	MonsterSystem *monsters = DataCenter::get_instance()->monsters;
+	events.clear();
+	for(vector<GameEvent> &buffer : buffers) {
+		events.insert(events.end(), buffer.begin(), buffer.end());
+		buffer.clear();
+	}
+	sort(events.begin(), events.end(), [](const GameEvent &a, const GameEvent &b) {
+		if(a.type != b.type) return a.type < b.type;
+		if(a.key != b.key) return a.key < b.key;
+		if(a.monster != b.monster) return a.monster < b.monster;
+		return a.value < b.value;
+	});
+	log.clear();
+	touched.clear();
+	size_t k = 0;
+	for(; k < events.size() && events[k].type <= EventType::ARRIVE; ++k)
+		_apply(events[k]);
+	// A monster may be damaged by several projectiles. Records of the same monster are merged, and the last one tells whether it has arrived.
+	sort(touched.begin(), touched.end());
+	for(size_t t = 0; t < touched.size(); ++t) {
+		if(t + 1 < touched.size() && touched[t + 1].first == touched[t].first) continue;
+		_settle(touched[t].first, touched[t].second);
+	}
+	for(; k < events.size(); ++k)
+		_apply(events[k]);
+	ScriptCenter::get_instance()->dispatch(log);
+	// All monsters killed or reaching the end in this frame are removed together.
+	monsters->compact();
+}
+
+void
+EventCenter::_apply(const GameEvent &e) {
+	DataCenter *DC = DataCenter::get_instance();
+	MonsterSystem *monsters = DC->monsters;
+	Player *player = DC->player;
+	switch(e.type) {
+		case EventType::DAMAGE: case EventType::POISON: {
+			monsters->HP[e.monster] -= e.value;
+			stats.damage += e.value;
+			touched.emplace_back(e.monster, false);
+			log.push_back(e);
+			break;
+		} case EventType::CONTACT: {
+			if(monsters->is_dead(e.monster)) break;
+			player->HP--;
+			debug_log("<EventCenter> hero HP: %d\n", player->HP);
+			monsters->mark_dead(e.monster);
+			stats.contacts++;
+			log.push_back(e);
+			break;
+		} case EventType::ARRIVE: {
+			touched.emplace_back(e.monster, true);
+			break;
+		} case EventType::EFFECT: {
+			if(monsters->is_dead(e.monster)) break;
+			monsters->apply_effect(e.monster, e.value);
+			log.push_back(e);
+			break;
+		} case EventType::COIN: {
+			player->coin += e.value;
+			stats.coins += e.value;
+			log.push_back(e);
+			break;
+		} case EventType::KILL: case EventType::LEAK: {
+			GAME_ASSERT(false, "kills and leaks are only produced by EventCenter::reduce().");
+		}
+	}
+}
+
+/**
+ * @brief Kill the i-th monster if it has no HP left, or let it leak if it has arrived at the end.
+ */
+void
+EventCenter::_settle(size_t i, bool arrived) {
+	DataCenter *DC = DataCenter::get_instance();
+	MonsterSystem *monsters = DC->monsters;
+	Player *player = DC->player;
+	// The monster is already removed by other interactions (e.g. touching the hero).
+	if(monsters->is_dead(i)) return;
+	const size_t type = static_cast<size_t>(monsters->owner[i]->get_type());
+	if(monsters->HP[i] <= 0) {
+		// Monster gets killed. Player receives money.
+		int money = monsters->owner[i]->get_money();
+		player->coin += money;
+		stats.kills[type]++;
+		stats.coins += money;
+		monsters->mark_dead(i);
+		log.push_back(GameEvent{EventType::KILL, i, i, money});
+	} else if(arrived) {
+		// Monster reaches the end. Player gets hurt.
+		player->HP--;
+		stats.leaks[type]++;
+		monsters->mark_dead(i);
+		log.push_back(GameEvent{EventType::LEAK, i, i, 1});
+	}
+}
@@ -0,0 +1,91 @@
+#ifndef EVENTCENTER_H_INCLUDED
+#define EVENTCENTER_H_INCLUDED
+
+#include "../monsters/Monster.h"
+#include <vector>
+#include <array>
+#include <cstddef>
+
+enum class EventType {
+	DAMAGE, POISON, CONTACT, ARRIVE, KILL, LEAK, EFFECT, COIN
+};
+
+/**
+ * @brief Something that changes monsters or the player, recorded during a frame and applied by EventCenter::reduce().
+ * @details * DAMAGE: a projectile or beam (key) hits the monster and reduces its HP by value.
+ * @details * POISON: the poison on the monster (key) reduces its HP by value.
+ * @details * CONTACT: the monster (key) touches the hero.
+ * @details * ARRIVE: the monster (key) reaches the end of the road.
+ * @details * KILL: the monster (key) is killed and the player earns value coins. Only produced by reduce().
+ * @details * LEAK: the monster (key) reaches the end alive and the player loses value HP. Only produced by reduce().
+ * @details * EFFECT: a projectile or beam (key) puts the status effect of id value on the monster.
+ * @details * COIN: the player earns value coins.
+ */
+struct GameEvent {
+	EventType type;
+	size_t key;
+	size_t monster;
+	int value;
+};
+
+/**
+ * @brief Running totals of the applied events.
+ */
+struct EventStats {
+	std::array<int, static_cast<size_t>(MonsterType::MONSTERTYPE_MAX)> kills{};
+	std::array<int, static_cast<size_t>(MonsterType::MONSTERTYPE_MAX)> leaks{};
+	int contacts = 0;
+	long long damage = 0;
+	long long coins = 0;
+};
+
+/**
+ * @brief Collects the hits, kills, leaks and coin gains of a frame and applies them at the end of the frame.
+ * @details Every thread of JobCenter emits into its own buffer, so collision detection and movement could run on many threads without locks. reduce() merges the buffers and applies the events in an order that does not depend on which thread emitted them, so the result is the same with any number of threads.
+ * Applied events (including the kills and leaks they cause) are kept in the log of the frame and added to the statistics.
+ */
+class EventCenter
+{
+public:
+	static EventCenter *get_instance() {
+		static EventCenter EC;
+		return &EC;
+	}
+	void set_thread_count(size_t n);
+	/**
+	 * @brief Record an event. Thread-safe among different threads of JobCenter.
+	 */
+	void emit(EventType type, size_t key, size_t monster, int value);
+	void reduce();
+	void reset_stats() { stats = EventStats{}; }
+	const EventStats &get_stats() const { return stats; }
+	const std::vector<GameEvent> &get_log() const { return log; }
+private:
+	EventCenter() : buffers(1) {}
+	void _apply(const GameEvent &e);
+	void _settle(size_t i, bool arrived);
+private:
+	/**
+	 * @var buffers
+	 * @brief Events emitted by each thread in this frame, indexed by JobCenter::get_thread_index().
+	 **
+	 * @var events
+	 * @brief Events of all buffers merged by reduce().
+	 **
+	 * @var log
+	 * @brief Events applied by the last reduce(), in the order they were applied.
+	 **
+	 * @var touched
+	 * @brief Monsters damaged or arrived in this frame, to be checked for kills and leaks.
+	 **
+	 * @var stats
+	 * @brief Totals of all applied events since the last reset_stats().
+	 */
+	std::vector<std::vector<GameEvent>> buffers;
+	std::vector<GameEvent> events;
+	std::vector<GameEvent> log;
+	std::vector<std::pair<size_t, bool>> touched;
+	EventStats stats;
+};
+
+#endif
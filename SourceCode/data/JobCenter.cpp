@@ -0,0 +1,201 @@
+#include "JobCenter.h"
+#include "../Utils.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Index of the queue owned by the current thread. The main thread and threads outside the pool use 0.
+ */
+static thread_local size_t thread_index = 0;
+
+/**
+ * @brief Add a plain job running f once.
+ * @param deps jobs that must finish before f starts. They must be added before this job.
+ * @return Id of the job.
+ */
+JobGraph::JobId
+JobGraph::add(function<void()> f, initializer_list<JobId> deps) {
+	return _add(Job{[f = move(f)](size_t, size_t) { f(); }, nullptr, 1, 0, {}}, deps);
+}
+
+/**
+ * @brief Add a range job calling f(begin, end) on chunks covering [0, n).
+ * @details Chunks of a range job may run at the same time, so f must only touch data of its own indices.
+ * @param grain largest number of indices of a chunk.
+ * @param deps jobs that must finish before any chunk starts. They must be added before this job.
+ * @return Id of the job.
+ */
+JobGraph::JobId
+JobGraph::add_range(size_t n, size_t grain, function<void(size_t, size_t)> f, initializer_list<JobId> deps) {
+	return add_range([n]() { return n; }, grain, move(f), deps);
+}
+
+/**
+ * @brief Add a range job whose number of indices is only known after the jobs it depends on have finished, e.g. the size of a container they append to.
+ */
+JobGraph::JobId
+JobGraph::add_range(function<size_t()> count, size_t grain, function<void(size_t, size_t)> f, initializer_list<JobId> deps) {
+	return _add(Job{move(f), move(count), max<size_t>(grain, 1), 0, {}}, deps);
+}
+
+JobGraph::JobId
+JobGraph::_add(Job &&job, initializer_list<JobId> deps) {
+	JobId id = jobs.size();
+	for(JobId dep : deps) {
+		GAME_ASSERT(dep < id, "job %zu depends on a job added later.", id);
+		jobs[dep].next.emplace_back(id);
+		++job.deps;
+	}
+	jobs.emplace_back(move(job));
+	return id;
+}
+
+/**
+ * @brief Index of the calling thread in the pool, from 0 (the main thread) to get_worker_count().
+ * @details Jobs could use it to write into per-thread buffers without locks.
+ */
+size_t
+JobCenter::get_thread_index() {
+	return thread_index;
+}
+
+JobCenter::~JobCenter() {
+	_stop();
+}
+
+/**
+ * @brief Restart the pool with worker_count worker threads. 0 runs every graph on the calling thread.
+ */
+void
+JobCenter::init(size_t worker_count) {
+	_stop();
+	queues = make_unique<Queue[]>(worker_count + 1);
+	quit = false;
+	for(size_t i = 0; i < worker_count; ++i)
+		workers.emplace_back([this, i]() { _work(i + 1); });
+	debug_log("<JobCenter> start %zu workers.\n", worker_count);
+}
+
+void
+JobCenter::_stop() {
+	{
+		lock_guard<mutex> lk(sleep_lock);
+		quit = true;
+	}
+	wake.notify_all();
+	for(thread &worker : workers)
+		worker.join();
+	workers.clear();
+}
+
+/**
+ * @brief Run every job of the graph and return after all of them have finished.
+ * @details The calling thread runs chunks as well. Only one graph may run at a time.
+ */
+void
+JobCenter::run(JobGraph &graph) {
+	const size_t n = graph.jobs.size();
+	if(n == 0) return;
+	this->graph = &graph;
+	if(n > job_capacity) {
+		waiting = make_unique<atomic<size_t>[]>(n);
+		chunks_left = make_unique<atomic<size_t>[]>(n);
+		job_capacity = n;
+	}
+	for(size_t i = 0; i < n; ++i)
+		waiting[i] = graph.jobs[i].deps;
+	jobs_left = n;
+	for(size_t i = 0; i < n; ++i)
+		if(graph.jobs[i].deps == 0) _ready(0, i);
+	if(!workers.empty()) {
+		{
+			lock_guard<mutex> lk(sleep_lock);
+			running = true;
+		}
+		wake.notify_all();
+	}
+	Task task;
+	while(jobs_left > 0) {
+		if(_take(0, task)) _execute(0, task);
+		else this_thread::yield();
+	}
+	if(!workers.empty()) {
+		lock_guard<mutex> lk(sleep_lock);
+		running = false;
+	}
+	this->graph = nullptr;
+}
+
+/**
+ * @brief Main loop of a worker owning queues[q].
+ */
+void
+JobCenter::_work(size_t q) {
+	thread_index = q;
+	Task task;
+	while(true) {
+		{
+			unique_lock<mutex> lk(sleep_lock);
+			wake.wait(lk, [this]() { return running || quit; });
+			if(quit) return;
+		}
+		if(_take(q, task)) _execute(q, task);
+		else this_thread::yield();
+	}
+}
+
+/**
+ * @brief Take a chunk from the back of queues[q], or steal one from the front of another queue.
+ */
+bool
+JobCenter::_take(size_t q, Task &task) {
+	{
+		lock_guard<mutex> lk(queues[q].lock);
+		if(!queues[q].tasks.empty()) {
+			task = queues[q].tasks.back();
+			queues[q].tasks.pop_back();
+			return true;
+		}
+	}
+	const size_t m = workers.size() + 1;
+	for(size_t k = 1; k < m; ++k) {
+		Queue &victim = queues[(q + k) % m];
+		lock_guard<mutex> lk(victim.lock);
+		if(!victim.tasks.empty()) {
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Run a chunk. The thread finishing the last chunk of a job makes the jobs depending on it ready.
+ */
+void
+JobCenter::_execute(size_t q, const Task &task) {
+	const JobGraph::Job &job = graph->jobs[task.job];
+	job.f(task.begin, task.end);
+	if(chunks_left[task.job].fetch_sub(1) != 1) return;
+	for(size_t next : job.next)
+		if(waiting[next].fetch_sub(1) == 1) _ready(q, next);
+	// This must be the last access to the graph, since run() may return right after.
+	jobs_left.fetch_sub(1);
+}
+
+/**
+ * @brief Split a job whose dependencies have finished into chunks and push them to queues[q].
+ * @details Chunks are pushed in reverse order, so the owner takes them in index order. An empty range job still has one empty chunk.
+ */
+void
+JobCenter::_ready(size_t q, size_t job) {
+	const JobGraph::Job &j = graph->jobs[job];
+	const size_t n = j.count ? j.count() : 1;
+	const size_t chunks = max<size_t>(1, (n + j.grain - 1) / j.grain);
+	chunks_left[job] = chunks;
+	lock_guard<mutex> lk(queues[q].lock);
+	for(size_t c = chunks; c-- > 0;)
+		queues[q].tasks.push_back(Task{job, c * j.grain, min(n, (c + 1) * j.grain)});
+}
@@ -0,0 +1,138 @@
+#ifndef JOBCENTER_H_INCLUDED
+#define JOBCENTER_H_INCLUDED
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+/**
+ * @brief A set of jobs and the dependencies between them, executed by JobCenter::run().
+ * @details A job only starts after all jobs it depends on have finished. A range job covers the indices [0, n) and is split into chunks of at most grain indices, which may run on different threads at the same time.
+ * The graph only describes the work, so it could be built once and run many times.
+ */
+class JobGraph
+{
+	friend class JobCenter;
+public:
+	using JobId = size_t;
+	JobId add(std::function<void()> f, std::initializer_list<JobId> deps = {});
+	JobId add_range(size_t n, size_t grain, std::function<void(size_t, size_t)> f, std::initializer_list<JobId> deps = {});
+	JobId add_range(std::function<size_t()> count, size_t grain, std::function<void(size_t, size_t)> f, std::initializer_list<JobId> deps = {});
+	void clear() { jobs.clear(); }
+	size_t size() const { return jobs.size(); }
+private:
+	/**
+	 * @var f
+	 * @brief Work of a chunk [begin, end).
+	 **
+	 * @var count
+	 * @brief Number of indices, evaluated when the job becomes ready. A plain job has one index.
+	 **
+	 * @var grain
+	 * @brief Largest number of indices in a chunk.
+	 **
+	 * @var deps
+	 * @brief Number of jobs this job depends on.
+	 **
+	 * @var next
+	 * @brief Jobs depending on this job.
+	 */
+	struct Job {
+		std::function<void(size_t, size_t)> f;
+		std::function<size_t()> count;
+		size_t grain;
+		size_t deps;
+		std::vector<JobId> next;
+	};
+	JobId _add(Job &&job, std::initializer_list<JobId> deps);
+	std::vector<Job> jobs;
+};
+
+/**
+ * @brief Runs JobGraph with a pool of worker threads.
+ * @details Every thread (the main thread included) owns a queue of chunks. A thread pushes the chunks of the jobs it makes ready to its own queue and takes them back from the end it pushed to, so related chunks tend to stay on one thread. A thread with an empty queue steals chunks from the other end of the queues of other threads.
+ * Workers sleep while no graph is running. With no worker thread, the main thread runs every chunk by itself in the same order as a serial loop.
+ */
+class JobCenter
+{
+public:
+	static JobCenter *get_instance() {
+		static JobCenter JC;
+		return &JC;
+	}
+	~JobCenter();
+	void init(size_t worker_count);
+	void run(JobGraph &graph);
+	size_t get_worker_count() const { return workers.size(); }
+	static size_t get_thread_index();
+private:
+	JobCenter() {}
+	struct Task {
+		size_t job;
+		size_t begin, end;
+	};
+	/**
+	 * @brief Queue of chunks owned by a thread. The owner uses the back, thieves use the front.
+	 */
+	struct Queue {
+		std::mutex lock;
+		std::deque<Task> tasks;
+	};
+	void _stop();
+	void _work(size_t q);
+	bool _take(size_t q, Task &task);
+	void _execute(size_t q, const Task &task);
+	void _ready(size_t q, size_t job);
+private:
+	/**
+	 * @var workers
+	 * @brief Worker threads. The i-th worker owns queues[i + 1], and the main thread owns queues[0].
+	 **
+	 * @var queues
+	 * @brief Queue of every thread.
+	 **
+	 * @var sleep_lock
+	 * @brief Protects running and quit for workers waiting on wake.
+	 **
+	 * @var running
+	 * @brief Whether a graph is running.
+	 **
+	 * @var quit
+	 * @brief Whether workers should exit.
+	 **
+	 * @var graph
+	 * @brief The running graph.
+	 **
+	 * @var waiting
+	 * @brief Number of unfinished dependencies of each job of the running graph.
+	 **
+	 * @var chunks_left
+	 * @brief Number of unfinished chunks of each ready job of the running graph.
+	 **
+	 * @var job_capacity
+	 * @brief Length of waiting and chunks_left.
+	 **
+	 * @var jobs_left
+	 * @brief Number of unfinished jobs of the running graph.
+	 */
+	std::vector<std::thread> workers;
+	std::unique_ptr<Queue[]> queues = std::make_unique<Queue[]>(1);
+	std::mutex sleep_lock;
+	std::condition_variable wake;
+	bool running = false;
+	bool quit = false;
+	JobGraph *graph = nullptr;
+	std::unique_ptr<std::atomic<size_t>[]> waiting;
+	std::unique_ptr<std::atomic<size_t>[]> chunks_left;
+	size_t job_capacity = 0;
+	std::atomic<size_t> jobs_left{0};
+};
+
+#endif
@@ -1,174 +1,123 @@
 #include "OperationCenter.h"
 #include "DataCenter.h"
-#include "../monsters/Monster.h"
+#include "../monsters/MonsterSystem.h"
 #include "../towers/Tower.h"
-#include "../towers/Bullet.h"
-#include "../Player.h"
+#include "../towers/TowerSystem.h"
+#include "../towers/TowerCoverage.h"
+#include "../towers/EngagementScheduler.h"
+#include "../projectiles/ProjectileSystem.h"
+#include "../projectiles/BeamSystem.h"
+#include "EventCenter.h"
 #include "../hero/Hero.h"
-#include "../hero/Rocket.h"
-#include <iostream>
+#include "../shapes/Shape.h"
 
+namespace OperationSetting {
+	// Largest number of entities updated by one job chunk.
+	constexpr size_t monster_grain = 1024;
+	constexpr size_t projectile_grain = 1024;
+}
+
+/**
+ * @details The update runs as a graph of phases on JobCenter:
+ * @details * Monster movement, engagement events of towers, and movement of projectiles already flying are independent, and run at the same time.
+ * @details * Monsters are registered on the broadphase grid and the road cells, then the towers of every type pick their targets.
+ * @details * Towers attack type by type, and the new projectiles move their first step. Hitscan towers hit their targets right away.
+ * @details * Every projectile looks for the monster it hits, and monsters touching the hero are found. Both are sent to EventCenter, which applies them together with kills and leaks at the end of the frame.
+ * @details Work on entities is split into chunks that only write their own entities, and everything that depends on order runs in a single job, so the result is the same as running the phases one by one on one thread.
+ */
 void OperationCenter::update() {
+	using namespace OperationSetting;
+	DataCenter *DC = DataCenter::get_instance();
+	MonsterSystem *monsters = DC->monsters;
+	ProjectileSystem *projectiles = DC->projectiles;
+	TowerSystem *towers = DC->towers;
+	monsters->begin_update();
+	flying = projectiles->size();
+
+	graph.clear();
 	// Update monsters.
-	_update_monster();
+	JobGraph::JobId move_monster = graph.add_range(monsters->size(), monster_grain, [monsters](size_t begin, size_t end) {
+		monsters->update_range(begin, end);
+	});
+	// Apply the predicted enter and leave events of this frame.
+	JobGraph::JobId engage = graph.add([DC]() { DC->engagement->advance(); });
+	// Move projectiles. Projectiles that fly too far (exceed their fly distance limit) are marked dead.
+	JobGraph::JobId move_projectile = graph.add_range(flying, projectile_grain, [projectiles](size_t begin, size_t end) {
+		projectiles->update_range(begin, end);
+	});
+	// Towers look for targets on the road cells they cover.
+	JobGraph::JobId locate = graph.add([DC, monsters]() {
+		monsters->end_update();
+		DC->coverage->register_monsters(monsters);
+	}, {move_monster});
+	JobGraph::JobId aim = graph.add_range(static_cast<size_t>(TowerType::TOWERTYPE_MAX), 1, [towers](size_t begin, size_t end) {
+		for(size_t t = begin; t < end; ++t)
+			towers->aim(static_cast<TowerType>(t));
+	}, {locate, engage});
 	// Update towers.
-	_update_tower();
-	// Update tower bullets.
-	_update_towerBullet();
-	// If any bullet overlaps with any monster, we delete the bullet, reduce the HP of the monster, and delete the monster if necessary.
-	_update_monster_towerBullet();
-	// If any monster reaches the end, hurt the player and delete the monster.
-	_update_monster_player();
+	JobGraph::JobId fire = graph.add([this]() { _update_tower(); }, {aim, move_projectile});
+	// If any projectile overlaps with any monster, we delete the projectile and damage the monster.
+	JobGraph::JobId collide = graph.add_range([projectiles]() { return projectiles->size(); }, projectile_grain, [monsters, projectiles](size_t begin, size_t end) {
+		projectiles->find_hits(monsters, begin, end);
+	}, {fire});
 	// hero touch monster
-	_update_hero_monster();
-
-	_update_rocket();
-	_update_monster_rocket();
-}
-
-void OperationCenter::_update_monster() {
-	std::vector<Monster*> &monsters = DataCenter::get_instance()->monsters;
-	for(Monster *monster : monsters)
-		monster->update();
+	JobGraph::JobId contact = graph.add([this]() { _update_hero_monster(); }, {locate});
+	// Remove the projectiles that expired or hit a monster in this frame.
+	graph.add([this]() { _compact_projectiles(); }, {collide, contact});
+	EventCenter::get_instance()->set_thread_count(JobCenter::get_instance()->get_worker_count() + 1);
+	JobCenter::get_instance()->run(graph);
 }
 
+/**
+ * @brief Towers attack their targets. Projectiles launched here missed the movement phase, so they move their first step here.
+ * @details Expired beams are dropped first, so beams fired in this frame append to a short list.
+ */
 void OperationCenter::_update_tower() {
-	std::vector<Tower*> &towers = DataCenter::get_instance()->towers;
-	for(Tower *tower : towers)
-		tower->update();
-}
-
-void OperationCenter::_update_towerBullet() {
-	std::vector<Bullet*> &towerBullets = DataCenter::get_instance()->towerBullets;
-	for(Bullet *towerBullet : towerBullets)
-		towerBullet->update();
-	// Detect if a bullet flies too far (exceeds its fly distance limit), which means the bullet lifecycle has ended.
-	for(size_t i = 0; i < towerBullets.size(); ++i) {
-		if(towerBullets[i]->get_fly_dist() <= 0) {
-			towerBullets.erase(towerBullets.begin()+i);
-			--i;
-		}
-	}
-}
-
-void OperationCenter::_update_monster_towerBullet() {
 	DataCenter *DC = DataCenter::get_instance();
-	std::vector<Monster*> &monsters = DC->monsters;
-	std::vector<Bullet*> &towerBullets = DC->towerBullets;
-	for(size_t i = 0; i < monsters.size(); ++i) {
-		for(size_t j = 0; j < towerBullets.size(); ++j) {
-			// Check if the bullet overlaps with the monster.
-			if(monsters[i]->shape->overlap(*(towerBullets[j]->shape))) {
-				// Reduce the HP of the monster. Delete the bullet.
-				monsters[i]->HP -= towerBullets[j]->get_dmg();
-				towerBullets.erase(towerBullets.begin()+j);
-				--j;
-			}
-		}
-	}
+	DC->beams->update();
+	DC->towers->fire();
+	DC->projectiles->update_range(flying, DC->projectiles->size());
 }
 
-void OperationCenter::_update_hero_monster() {
-	DataCenter *DC = DataCenter::get_instance();
-    std::vector<Monster*> &monsters = DC->monsters;
-    size_t i = 0;
-    while (i < monsters.size()) {
-        if (monsters[i]->shape->overlap(*(DC->hero->shape))) {
-            DC->player->HP--;
-            // 輸出偵錯訊息
-            std::cout << "!!! Hero HP: " << DC->player->HP << std::endl;
-            // 刪除怪物並從容器中移除
-            delete monsters[i];
-            monsters.erase(monsters.begin() + i);
-        } else {
-            ++i;
-        }
-    }
-}
-
-void OperationCenter::_update_monster_player() {
-	DataCenter *DC = DataCenter::get_instance();
-	std::vector<Monster*> &monsters = DC->monsters;
-	Player *&player = DC->player;
-	for(size_t i = 0; i < monsters.size(); ++i) {
-		// Check if the monster is killed.
-		if(monsters[i]->HP <= 0) {
-			// Monster gets killed. Player receives money.
-			player->coin += monsters[i]->get_money();
-			monsters.erase(monsters.begin()+i);
-			--i;
-			// Since the current monsster is killed, we can directly proceed to next monster.
-			break;
-		}
-		// Check if the monster reaches the end.
-		if(monsters[i]->get_path().empty()) {
-			monsters.erase(monsters.begin()+i);
-			player->HP--;
-			--i;
-		}
-	}
+void OperationCenter::_compact_projectiles() {
+	// Projectiles that expired or hit a monster in this frame are removed together.
+	DataCenter::get_instance()->projectiles->compact();
 }
 
-void OperationCenter::_update_monster_rocket(){
+void OperationCenter::_update_hero_monster() {
 	DataCenter *DC = DataCenter::get_instance();
-	std::vector<Monster*> &monsters = DC -> monsters;
-	std::vector<Rocket*> &rockets = DC -> rockets;
-	for(size_t i = 0; i < monsters.size(); ++i) {
-		for(size_t j = 0; j < rockets.size(); ++j) {
-			// Check if the rockets overlaps with the monster.
-			if(monsters[i] -> shape -> overlap(*(rockets[j] -> shape))) {
-				// Reduce the HP of the monster. Delete the rockets.
-				monsters[i]->HP -= rockets[j]->get_dmg();
-				delete rockets[j];
-				rockets.erase(rockets.begin() + j);
-				--j;
-				break;
-			}
-		}
-	}
-}
-
-void OperationCenter::_update_rocket() {
-    std::vector<Rocket*> &rockets = DataCenter::get_instance()->rockets;
-	for(Rocket *rocket : rockets) rocket->update();
-    for (size_t i = 0; i < rockets.size(); ++i) {
-        if (rockets[i]->get_remaining_range() <= 0) {
-            delete rockets[i];
-            rockets.erase(rockets.begin() + i);
-            --i;
+    MonsterSystem *monsters = DC->monsters;
+    EventCenter *EC = EventCenter::get_instance();
+    // 只檢查 hero 所在及相鄰格子裡的怪物
+    monsters->grid.query(DC->hero->shape, [&](size_t i) {
+        if (monsters->is_dead(i)) return;
+        if (checkOverlap(monsters->hitbox(i), DC->hero->shape)) {
+            // 由 EventCenter::reduce 扣除玩家 HP 並一次從容器中移除怪物
+            EC->emit(EventType::CONTACT, i, i, 1);
         }
-    }
+    });
 }
 
 void OperationCenter::draw() {
 	_draw_monster();
 	_draw_tower();
-	_draw_towerBullet();
-	_draw_rocket();
+	_draw_projectile();
+	_draw_beam();
 }
 
 void OperationCenter::_draw_monster() {
-	std::vector<Monster*> &monsters = DataCenter::get_instance()->monsters;
-	for(Monster *monster : monsters)
-		monster->draw();
+	DataCenter::get_instance()->monsters->draw();
 }
 
 void OperationCenter::_draw_tower() {
-	std::vector<Tower*> &towers = DataCenter::get_instance()->towers;
-	for(Tower *tower : towers)
+	for(Tower *tower : *DataCenter::get_instance()->towers)
 		tower->draw();
 }
 
-void OperationCenter::_draw_towerBullet() {
-	std::vector<Bullet*> &towerBullets = DataCenter::get_instance()->towerBullets;
-	for(Bullet *towerBullet : towerBullets)
-		towerBullet->draw();
+void OperationCenter::_draw_projectile() {
+	DataCenter::get_instance()->projectiles->draw();
 }
 
-void OperationCenter::_draw_rocket(){
-	DataCenter *DC = DataCenter::get_instance();
-	std::vector<Rocket*> &rockets = DC->rockets;
-    for (Rocket *rocket : rockets) {
-        rocket->draw();
-    }
+void OperationCenter::_draw_beam() {
+	DataCenter::get_instance()->beams->draw();
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef OPERATIONCENTER_H_INCLUDED
 #define OPERATIONCENTER_H_INCLUDED
 
+#include "JobCenter.h"
+#include <vector>
+
 /**
  * @brief Class that defines functions for all object operations.
  * @details Object self-update, draw, and object-to-object interact functions are defined here.
@@ -25,21 +28,23 @@ public:
 private:
 	OperationCenter() {}
 private:
-	void _update_monster();
 	void _update_tower();
-	void _update_towerBullet();
-	void _update_monster_towerBullet();
-	void _update_monster_player();
+	void _compact_projectiles();
 	void _update_hero_monster();
-	
-	void _update_rocket();
-	void _update_monster_rocket();
 private:
 	void _draw_monster();
 	void _draw_tower();
-	void _draw_towerBullet();
-	
-	void _draw_rocket();
+	void _draw_projectile();
+	void _draw_beam();
+private:
+	/**
+	 * @brief Phases of update() and their dependencies, rebuilt every frame.
+	 */
+	JobGraph graph;
+	/**
+	 * @brief Number of projectiles before towers attack in this frame.
+	 */
+	size_t flying;
 };
 
 #endif
@@ -0,0 +1,284 @@
+#include "ScriptCenter.h"
+#include "DataCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../Utils.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace std;
+
+// fixed settings
+namespace ScriptSetting {
+	// Coroutine frames up to max_pooled_frame bytes are pooled in size classes of frame_class bytes.
+	constexpr size_t frame_class = 64;
+	constexpr size_t max_pooled_frame = 1024;
+	// Number of frames allocated at once when a size class runs out.
+	constexpr size_t frames_per_chunk = 32;
+	// Longest sleep of a script waiting for a path position before it checks again.
+	constexpr double max_path_sleep = 3600;
+}
+
+/**
+ * @brief Free lists of coroutine frames, one per size class. A free frame stores the next free frame in its first bytes.
+ * @details The pool is initialized at compile time, so it outlives ScriptCenter and scripts destroyed at exit can still return their frames. Memory of the pool is only released at exit.
+ */
+struct FramePool {
+	array<void*, ScriptSetting::max_pooled_frame / ScriptSetting::frame_class> free_list{};
+	vector<void*> chunks;
+	~FramePool() {
+		for(void *chunk : chunks)
+			::operator delete(chunk);
+	}
+};
+static FramePool frame_pool;
+
+template<typename T>
+static vector<T> &grow_to(vector<vector<T>> &lists, size_t k) {
+	if(lists.size() <= k) lists.resize(k + 1);
+	return lists[k];
+}
+
+void
+Script::promise_type::unhandled_exception() {
+	GAME_ASSERT(false, "uncaught exception in a script.\n");
+}
+
+void*
+Script::promise_type::operator new(size_t size) {
+	return ScriptCenter::allocate_frame(size);
+}
+
+void
+Script::promise_type::operator delete(void *p, size_t size) {
+	ScriptCenter::free_frame(p, size);
+}
+
+void
+WaitTicks::await_suspend(Script::Handle h) {
+	ScriptCenter::get_instance()->_wait_ticks(h.promise().slot, ticks);
+}
+
+bool
+WaitPath::await_suspend(Script::Handle h) {
+	return ScriptCenter::get_instance()->_wait_path(h.promise().slot, dist);
+}
+
+void
+WaitEvent::await_suspend(Script::Handle h) {
+	ScriptCenter::get_instance()->_wait_event(h.promise().slot, this);
+}
+
+ScriptCenter::~ScriptCenter() {
+	for(Slot &s : slots) {
+		if(s.handle) s.handle.destroy();
+	}
+}
+
+/**
+ * @brief Get memory for a coroutine frame from the pool. Frames larger than ScriptSetting::max_pooled_frame come from the heap.
+ */
+void*
+ScriptCenter::allocate_frame(size_t size) {
+	using namespace ScriptSetting;
+	if(size == 0 || size > max_pooled_frame) return ::operator new(size);
+	const size_t c = (size - 1) / frame_class;
+	void *&head = frame_pool.free_list[c];
+	if(head == nullptr) {
+		const size_t bytes = (c + 1) * frame_class;
+		char *chunk = static_cast<char*>(::operator new(bytes * frames_per_chunk));
+		frame_pool.chunks.emplace_back(chunk);
+		for(size_t k = frames_per_chunk; k-- > 0;) {
+			*reinterpret_cast<void**>(chunk + k * bytes) = head;
+			head = chunk + k * bytes;
+		}
+	}
+	void *p = head;
+	head = *static_cast<void**>(p);
+	return p;
+}
+
+void
+ScriptCenter::free_frame(void *p, size_t size) {
+	using namespace ScriptSetting;
+	if(size == 0 || size > max_pooled_frame) {
+		::operator delete(p);
+		return;
+	}
+	void *&head = frame_pool.free_list[(size - 1) / frame_class];
+	*static_cast<void**>(p) = head;
+	head = p;
+}
+
+/**
+ * @brief Run the script until it first waits for something.
+ * @param owner id of the monster owning the script, or no_owner.
+ * @return Handle to stop the script or check whether it is still running.
+ */
+ScriptId
+ScriptCenter::start(Script script, size_t owner) {
+	size_t i = slots.size();
+	if(!free_slots.empty()) {
+		i = free_slots.back();
+		free_slots.pop_back();
+	} else slots.push_back(Slot{{}, no_owner, 1, 0, nullptr});
+	Slot &s = slots[i];
+	s.handle = exchange(script.handle, {});
+	s.owner = owner;
+	s.timer = 0;
+	s.event = nullptr;
+	s.handle.promise().slot = i;
+	if(owner != no_owner)
+		grow_to(owned, owner).emplace_back(i);
+	const ScriptId id = static_cast<ScriptId>(s.generation) << 32 | i;
+	_resume(i);
+	return id;
+}
+
+/**
+ * @brief Destroy a script wherever it is waiting.
+ * @return Whether the script was still running.
+ */
+bool
+ScriptCenter::stop(ScriptId id) {
+	const int i = _slot_of(id);
+	if(i == -1) return false;
+	_release(i);
+	return true;
+}
+
+/**
+ * @brief Stop the scripts owned by the monster of id uid, and the scripts waiting for events on it. Called when the monster is removed, before its id is reused.
+ */
+void
+ScriptCenter::remove_monster(size_t uid) {
+	if(uid < owned.size()) {
+		while(!owned[uid].empty())
+			_release(owned[uid].back());
+	}
+	if(uid < by_monster.size()) {
+		pending.swap(by_monster[uid]);
+		for(const Waiter &w : pending)
+			if(_is_valid(w)) _release(w.slot);
+		pending.clear();
+	}
+}
+
+/**
+ * @brief Resume the scripts waiting for the events of the log, in the order of the log. Called by EventCenter::reduce() before the removed monsters are gone.
+ * @details Only the waiters of each event type and of the monster of each event are looked up. A script waiting again for the same type is not woken by the event that resumed it.
+ */
+void
+ScriptCenter::dispatch(const vector<GameEvent> &log) {
+	const MonsterSystem *monsters = DataCenter::get_instance()->monsters;
+	for(const GameEvent &e : log) {
+		if(event_waits == 0) return;
+		const size_t t = static_cast<size_t>(e.type);
+		if(t < by_type.size() && !by_type[t].empty()) {
+			pending.swap(by_type[t]);
+			for(const Waiter &w : pending)
+				if(_is_valid(w)) _wake(w, e);
+			pending.clear();
+		}
+		// COIN events are not about any monster.
+		if(e.type == EventType::COIN || e.monster >= monsters->size()) continue;
+		const size_t uid = monsters->uid[e.monster];
+		if(uid < by_monster.size() && !by_monster[uid].empty()) {
+			pending.swap(by_monster[uid]);
+			for(const Waiter &w : pending) {
+				if(!_is_valid(w)) continue;
+				if(slots[w.slot].event->matches(e.type)) _wake(w, e);
+				else by_monster[uid].emplace_back(w);
+			}
+			pending.clear();
+		}
+	}
+}
+
+void
+ScriptCenter::_wait_ticks(size_t i, unsigned ticks) {
+	slots[i].timer = TimerCenter::get_instance()->schedule(ticks, [this, i]() { _resume(i); });
+}
+
+/**
+ * @return Whether the script has to sleep, i.e. the owner has not walked dist yet.
+ */
+bool
+ScriptCenter::_wait_path(size_t i, double dist) {
+	GAME_ASSERT(slots[i].owner != no_owner, "only scripts owned by a monster can wait for a path position.\n");
+	DataCenter *DC = DataCenter::get_instance();
+	const MonsterSystem *monsters = DC->monsters;
+	const size_t m = monsters->index(slots[i].owner);
+	if(monsters->dist[m] >= dist) return false;
+	// The monster walks at most speed / FPS pixels per tick, so it cannot arrive earlier.
+	const double ticks = ceil((dist - monsters->dist[m]) * DC->FPS / monsters->speed[m]);
+	slots[i].timer = TimerCenter::get_instance()->schedule(static_cast<unsigned>(clamp(ticks, 1., ScriptSetting::max_path_sleep)), [this, i, dist]() {
+		slots[i].timer = 0;
+		if(!_wait_path(i, dist)) _resume(i);
+	});
+	return true;
+}
+
+void
+ScriptCenter::_wait_event(size_t i, WaitEvent *awaiter) {
+	Slot &s = slots[i];
+	s.event = awaiter;
+	++event_waits;
+	const Waiter w{i, s.generation};
+	GAME_ASSERT(awaiter->uid != WaitEvent::any || awaiter->or_type == awaiter->type, "only waits on a monster can wait for two types of events.\n");
+	if(awaiter->uid == WaitEvent::any) grow_to(by_type, static_cast<size_t>(awaiter->type)).emplace_back(w);
+	else grow_to(by_monster, awaiter->uid).emplace_back(w);
+}
+
+void
+ScriptCenter::_wake(const Waiter &w, const GameEvent &e) {
+	Slot &s = slots[w.slot];
+	s.event->event = e;
+	s.event = nullptr;
+	--event_waits;
+	_resume(w.slot);
+}
+
+/**
+ * @brief Resume the i-th script, unless its owner is marked dead. A finished script is released.
+ */
+void
+ScriptCenter::_resume(size_t i) {
+	slots[i].timer = 0;
+	if(slots[i].owner != no_owner) {
+		const MonsterSystem *monsters = DataCenter::get_instance()->monsters;
+		// The script is destroyed together with the monster by the next compact.
+		if(monsters->is_dead(monsters->index(slots[i].owner))) return;
+	}
+	const Script::Handle h = slots[i].handle;
+	h.resume();
+	if(h.done()) _release(i);
+}
+
+/**
+ * @brief Destroy the coroutine of the i-th slot, cancel what it waits for, and free the slot.
+ */
+void
+ScriptCenter::_release(size_t i) {
+	Slot &s = slots[i];
+	TimerCenter::get_instance()->cancel(s.timer);
+	if(s.event) --event_waits;
+	if(s.owner != no_owner) {
+		vector<size_t> &v = owned[s.owner];
+		v.erase(find(v.begin(), v.end(), i));
+	}
+	s.handle.destroy();
+	s.handle = {};
+	s.owner = no_owner;
+	s.timer = 0;
+	s.event = nullptr;
+	if(++s.generation == 0) s.generation = 1;
+	free_slots.emplace_back(i);
+}
+
+int
+ScriptCenter::_slot_of(ScriptId id) const {
+	const size_t i = id & 0xffffffffu;
+	if(i >= slots.size() || !slots[i].handle || slots[i].generation != id >> 32) return -1;
+	return i;
+}
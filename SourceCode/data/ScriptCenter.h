@@ -0,0 +1,185 @@
+#ifndef SCRIPTCENTER_H_INCLUDED
+#define SCRIPTCENTER_H_INCLUDED
+
+#include "EventCenter.h"
+#include "TimerCenter.h"
+#include <coroutine>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Handle of a started script. 0 is never a valid handle.
+ */
+using ScriptId = uint64_t;
+
+/**
+ * @brief Coroutine type of behaviour scripts.
+ * @details A function returning Script is written as straight-line code that suspends on WaitTicks, WaitPath and WaitEvent. Calling it only creates the coroutine. It runs once it is passed to ScriptCenter::start().
+ * Coroutine frames are allocated from the frame pool of ScriptCenter, so starting and finishing scripts does not touch the heap once the pool has grown.
+ */
+class Script
+{
+public:
+	struct promise_type {
+		Script get_return_object() { return Script{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception();
+		static void *operator new(size_t size);
+		static void operator delete(void *p, size_t size);
+		/**
+		 * @brief Slot of the script in ScriptCenter.
+		 */
+		size_t slot = 0;
+	};
+	using Handle = std::coroutine_handle<promise_type>;
+	Script(Script &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+	Script(const Script&) = delete;
+	~Script() { if(handle) handle.destroy(); }
+private:
+	explicit Script(Handle handle) : handle(handle) {}
+	Handle handle;
+	friend class ScriptCenter;
+};
+
+/**
+ * @brief Suspend the script for a number of ticks.
+ * @details Resumed by a timer of TimerCenter, so a waiting script costs nothing in the ticks between.
+ */
+struct WaitTicks {
+	unsigned ticks;
+	bool await_ready() const { return ticks == 0; }
+	void await_suspend(Script::Handle h);
+	void await_resume() const {}
+};
+
+/**
+ * @brief Suspend the script until the monster owning it has walked dist pixels.
+ * @details Monsters never walk faster than their speed, so the script sleeps on a timer until the earliest tick the distance could be reached, and checks again then.
+ */
+struct WaitPath {
+	double dist;
+	bool await_ready() const { return false; }
+	bool await_suspend(Script::Handle h);
+	void await_resume() const {}
+};
+
+/**
+ * @brief Suspend the script until an event of the type is applied by EventCenter, optionally only on the monster of id uid.
+ * @details The event is returned by co_await. Its monster index is valid until the script suspends again.
+ * A wait on a monster may also be resumed by a second type of events, or_type.
+ */
+struct WaitEvent {
+	static constexpr size_t any = static_cast<size_t>(-1);
+	EventType type;
+	size_t uid = any;
+	EventType or_type = type;
+	GameEvent event{};
+	bool matches(EventType t) const { return t == type || t == or_type; }
+	bool await_ready() const { return false; }
+	void await_suspend(Script::Handle h);
+	GameEvent await_resume() const { return event; }
+};
+
+/**
+ * @brief Runs behaviour scripts of monsters and the hero as coroutines.
+ * @details A suspended script is only resumed when the condition it waits for is met: tick and path waits are timers of TimerCenter, and event waits are indexed by event type and by monster, so EventCenter::reduce() only looks up the waiters of the events of the frame. A script with nothing to wait for is not visited at all.
+ * A script may be owned by a monster. It is destroyed when the monster is removed, and not resumed once the monster is marked dead. A script must not stop itself, it returns instead.
+ * Scripts run on the main thread only: in timer callbacks and at the end of EventCenter::reduce().
+ */
+class ScriptCenter
+{
+public:
+	static ScriptCenter *get_instance() {
+		static ScriptCenter SC;
+		return &SC;
+	}
+	~ScriptCenter();
+	static constexpr size_t no_owner = static_cast<size_t>(-1);
+	ScriptId start(Script script, size_t owner = no_owner);
+	bool stop(ScriptId id);
+	void remove_monster(size_t uid);
+	bool is_running(ScriptId id) const { return _slot_of(id) != -1; }
+	void dispatch(const std::vector<GameEvent> &log);
+	size_t size() const { return slots.size() - free_slots.size(); }
+	static void *allocate_frame(size_t size);
+	static void free_frame(void *p, size_t size);
+private:
+	ScriptCenter() {}
+	friend struct WaitTicks;
+	friend struct WaitPath;
+	friend struct WaitEvent;
+	/**
+	 * @brief A script waiting for an event, stamped with the generation of its slot. The entry is stale if the slot has been reused since.
+	 */
+	struct Waiter {
+		size_t slot;
+		uint32_t generation;
+	};
+	void _wait_ticks(size_t i, unsigned ticks);
+	bool _wait_path(size_t i, double dist);
+	void _wait_event(size_t i, WaitEvent *awaiter);
+	void _wake(const Waiter &w, const GameEvent &e);
+	void _resume(size_t i);
+	void _release(size_t i);
+	bool _is_valid(const Waiter &w) const { return slots[w.slot].generation == w.generation && slots[w.slot].event != nullptr; }
+	int _slot_of(ScriptId id) const;
+private:
+	/**
+	 * @var handle
+	 * @brief The coroutine, or null if the slot is free.
+	 **
+	 * @var owner
+	 * @brief Id of the monster owning the script, or no_owner.
+	 **
+	 * @var generation
+	 * @brief Increased whenever the slot is released, so that old handles and waiters of the slot become invalid.
+	 **
+	 * @var timer
+	 * @brief Timer resuming the script, if it waits for ticks or a path position.
+	 **
+	 * @var event
+	 * @brief The awaiter receiving the event, if the script waits for an event.
+	 */
+	struct Slot {
+		Script::Handle handle;
+		size_t owner;
+		uint32_t generation;
+		TimerHandle timer;
+		WaitEvent *event;
+	};
+	/**
+	 * @var slots
+	 * @brief All scripts. A ScriptId is the slot index and generation of a script.
+	 **
+	 * @var free_slots
+	 * @brief Free slots, reused by the next started scripts.
+	 **
+	 * @var owned
+	 * @brief Slots of the scripts owned by each monster id.
+	 **
+	 * @var by_type
+	 * @brief Scripts waiting for any event of each type, indexed by the type.
+	 **
+	 * @var by_monster
+	 * @brief Scripts waiting for an event on each monster id.
+	 **
+	 * @var event_waits
+	 * @brief Number of scripts waiting for an event. dispatch() returns at once if it is 0.
+	 **
+	 * @var pending
+	 * @brief Buffer of the waiters being checked by dispatch().
+	 */
+	std::vector<Slot> slots;
+	std::vector<size_t> free_slots;
+	std::vector<std::vector<size_t>> owned;
+	std::vector<std::vector<Waiter>> by_type;
+	std::vector<std::vector<Waiter>> by_monster;
+	size_t event_waits = 0;
+	std::vector<Waiter> pending;
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "SoundCenter.h"
 #include "../Utils.h"
+#include "TimerCenter.h"
 
 
 using namespace std;
@@ -10,7 +11,7 @@ namespace SoundSetting {
 	constexpr int UPDATE_PERIOD = 60;
 }
 
-SoundCenter::SoundCenter () : update_period{SoundSetting::UPDATE_PERIOD} {}
+SoundCenter::SoundCenter () {}
 
 SoundCenter::~SoundCenter() {
 	for(auto &[path, sample_pair] : samples) {
@@ -22,10 +23,11 @@ SoundCenter::~SoundCenter() {
 }
 
 /**
- * @brief Reserve samples to have default mixer work.
+ * @brief Reserve samples to have default mixer work, and start cleaning up finished instances every UPDATE_PERIOD + 1 frames.
  */
 bool
 SoundCenter::init() {
+	TimerCenter::get_instance()->schedule(SoundSetting::UPDATE_PERIOD + 1, [this]() { update(); }, SoundSetting::UPDATE_PERIOD + 1);
 	bool res = true;
 	res &= al_restore_default_mixer();
 	res &= al_reserve_samples(SoundSetting::RESERVED_SAMPLES);
@@ -42,22 +44,17 @@ SoundCenter::init() {
  */
 void
 SoundCenter::update() {
-	if (update_period == 0) {
-		update_period = SoundSetting::UPDATE_PERIOD;
-		for(auto &[path, audio_pair] : samples) {
-			auto &[sample, insts] = audio_pair;
-			for(auto it = insts.begin(); it != insts.end();) {
-				if(al_get_sample_instance_playing(*it)) ++it;
-				else if(al_get_sample_instance_position(*it) != 0) ++it;
-				else if(al_get_sample_instance_playmode(*it) == ALLEGRO_PLAYMODE_LOOP) ++it;
-				else {
-					al_destroy_sample_instance(*it);
-					it = insts.erase(it);
-				}
+	for(auto &[path, audio_pair] : samples) {
+		auto &[sample, insts] = audio_pair;
+		for(auto it = insts.begin(); it != insts.end();) {
+			if(al_get_sample_instance_playing(*it)) ++it;
+			else if(al_get_sample_instance_position(*it) != 0) ++it;
+			else if(al_get_sample_instance_playmode(*it) == ALLEGRO_PLAYMODE_LOOP) ++it;
+			else {
+				al_destroy_sample_instance(*it);
+				it = insts.erase(it);
 			}
 		}
-	} else {
-		--update_period;
 	}
 }
 
@@ -107,6 +104,19 @@ SoundCenter::play(const string &path, ALLEGRO_PLAYMODE mode) {
 	return instance;
 }
 
+/**
+ * @brief Play a short sound effect once, unless the same effect has already been played in this displayed frame.
+ * @return The played instance, or nullptr if the effect is skipped.
+ * @see begin_frame()
+ */
+ALLEGRO_SAMPLE_INSTANCE*
+SoundCenter::play_effect(const string &path) {
+	auto [it, first] = effect_frame.try_emplace(path, frame);
+	if(!first && it->second == frame) return nullptr;
+	it->second = frame;
+	return play(path, ALLEGRO_PLAYMODE_ONCE);
+}
+
 /**
  * @brief Check is an instance is currently playing.
  */
@@ -12,7 +12,8 @@
 /**
  * @brief Stores and manages audio samples and instances.
  * @details All data related to basic allegro audio (ALLEGRO_SAMPLE and ALLEGRO_SAMPLE_INSTANCE) are all managed by SoundCenter.
- * If any sample instance has finished playing, the sample instance will be destroyed via update function.
+ * If any sample instance has finished playing, the sample instance will be destroyed via update function, which is called periodically by a timer started in init().
+ * Short sound effects are played through play_effect(), which plays the same sample at most once per displayed frame. When the game runs several simulation steps per frame, the effects of all steps collapse into one.
  */
 class SoundCenter
 {
@@ -26,6 +27,11 @@ public:
 	void update();
 	bool erase_sample(const std::string &path);
 	ALLEGRO_SAMPLE_INSTANCE *play(const std::string &path, ALLEGRO_PLAYMODE mode);
+	ALLEGRO_SAMPLE_INSTANCE *play_effect(const std::string &path);
+	/**
+	 * @brief Start a new displayed frame, so every sound effect can be played once again.
+	 */
+	void begin_frame() { ++frame; }
 	bool is_playing(const ALLEGRO_SAMPLE_INSTANCE *const inst);
 	void toggle_playing(ALLEGRO_SAMPLE_INSTANCE *inst);
 	void stop_instance(ALLEGRO_SAMPLE_INSTANCE* inst);
@@ -38,9 +44,14 @@ private:
 	 */
 	std::map<std::string, std::pair<ALLEGRO_SAMPLE*, std::vector<ALLEGRO_SAMPLE_INSTANCE*>>> samples;
 	/**
-	 * @brief Sound update period.
+	 * @var frame
+	 * @brief Number of displayed frames begun.
+	 **
+	 * @var effect_frame
+	 * @brief Frame in which each sound effect was played last.
 	 */
-	int update_period;
+	unsigned long long frame = 0;
+	std::map<std::string, unsigned long long> effect_frame;
 };
 
 #endif
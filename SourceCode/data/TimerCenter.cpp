@@ -0,0 +1,181 @@
+#include "TimerCenter.h"
+#include <utility>
+
+using namespace std;
+
+// fixed settings
+namespace TimerSetting {
+	constexpr int levels = 4;
+	constexpr int slot_bits = 6;
+	constexpr int slots = 1 << slot_bits;
+	constexpr int slot_mask = slots - 1;
+	//! @brief List of the timers firing in the current tick.
+	constexpr int pending_list = levels * slots;
+}
+
+TimerCenter::TimerCenter() : now{0}, heads(TimerSetting::pending_list + 1, -1), free_head{-1}, firing{false} {}
+
+/**
+ * @brief Call the callback after delay ticks.
+ * @param period if positive, the callback is called again every period ticks until the timer is cancelled.
+ * @return Handle to cancel the timer.
+ */
+TimerHandle
+TimerCenter::schedule(unsigned delay, function<void()> callback, unsigned period) {
+	if(delay == 0 && !firing) delay = 1;
+	int n = free_head;
+	if(n == -1) {
+		n = nodes.size();
+		nodes.push_back(Node{0, 0, 1, -1, -1, -1, {}});
+	} else {
+		free_head = nodes[n].next;
+	}
+	Node &node = nodes[n];
+	node.expires = now + delay;
+	node.period = period;
+	node.callback = std::move(callback);
+	_insert(n);
+	return (static_cast<uint64_t>(node.generation) << 32) | static_cast<uint64_t>(n + 1);
+}
+
+/**
+ * @brief Cancel a timer. Cancelling a timer that has fired (and is not periodic) or was cancelled does nothing.
+ * @return Whether the timer was pending.
+ */
+bool
+TimerCenter::cancel(TimerHandle handle) {
+	int n = _node_of(handle);
+	if(n == -1) return false;
+	_unlink(n);
+	_release(n);
+	return true;
+}
+
+bool
+TimerCenter::is_pending(TimerHandle handle) const {
+	return _node_of(handle) != -1;
+}
+
+/**
+ * @brief Advance one tick and call every callback due.
+ * @details Timers of upper levels whose slot is reached are first moved down to lower levels, then the timers in the current slot of the lowest level fire.
+ */
+void
+TimerCenter::update() {
+	using namespace TimerSetting;
+	++now;
+	int top = 0;
+	while(top + 1 < levels && ((now >> (slot_bits * (top + 1))) << (slot_bits * (top + 1))) == now) ++top;
+	for(int level = top; level >= 1; --level)
+		_cascade(level);
+
+	// Move the current slot to the pending list, so callbacks may schedule or cancel timers freely.
+	int &slot = heads[now & slot_mask];
+	heads[pending_list] = slot;
+	for(int n = slot; n != -1; n = nodes[n].next)
+		nodes[n].list = pending_list;
+	slot = -1;
+	firing = true;
+	while(heads[pending_list] != -1) {
+		int n = heads[pending_list];
+		uint32_t generation = nodes[n].generation;
+		unsigned period = nodes[n].period;
+		_unlink(n);
+		function<void()> callback = std::move(nodes[n].callback);
+		if(period) {
+			nodes[n].expires = now + period;
+			_insert(n);
+		} else {
+			_release(n);
+		}
+		callback();
+		// Give the callback back to a periodic timer unless it was cancelled in the callback.
+		if(period && nodes[n].generation == generation && nodes[n].list != -1)
+			nodes[n].callback = std::move(callback);
+	}
+	firing = false;
+}
+
+/**
+ * @brief Get the node of a handle, or -1 if the handle is not pending.
+ */
+int
+TimerCenter::_node_of(TimerHandle handle) const {
+	if(handle == 0) return -1;
+	int n = static_cast<int>(handle & 0xffffffffu) - 1;
+	uint32_t generation = static_cast<uint32_t>(handle >> 32);
+	if(n < 0 || n >= static_cast<int>(nodes.size())) return -1;
+	if(nodes[n].generation != generation || nodes[n].list == -1) return -1;
+	return n;
+}
+
+/**
+ * @brief Put the node into the slot matching its expire tick.
+ */
+void
+TimerCenter::_insert(int n) {
+	using namespace TimerSetting;
+	uint64_t expires = nodes[n].expires;
+	if(expires <= now) {
+		// Due in the current tick: fire with the current slot, or right away if the slot is already firing.
+		_link(n, firing ? pending_list : static_cast<int>(now & slot_mask));
+		return;
+	}
+	uint64_t diff = expires - now;
+	for(int level = 0; level < levels; ++level) {
+		if(diff < (1ULL << (slot_bits * (level + 1)))) {
+			_link(n, level * slots + static_cast<int>((expires >> (slot_bits * level)) & slot_mask));
+			return;
+		}
+	}
+	// Too far away: park in the last slot of the top level, and it will be inserted again when the slot is reached.
+	const int top = levels - 1;
+	_link(n, top * slots + static_cast<int>(((now >> (slot_bits * top)) + slot_mask) & slot_mask));
+}
+
+void
+TimerCenter::_link(int n, int list) {
+	Node &node = nodes[n];
+	node.list = list;
+	node.prev = -1;
+	node.next = heads[list];
+	if(heads[list] != -1) nodes[heads[list]].prev = n;
+	heads[list] = n;
+}
+
+void
+TimerCenter::_unlink(int n) {
+	Node &node = nodes[n];
+	if(node.prev != -1) nodes[node.prev].next = node.next;
+	else heads[node.list] = node.next;
+	if(node.next != -1) nodes[node.next].prev = node.prev;
+	node.list = -1;
+}
+
+/**
+ * @brief Return an unlinked node to the pool. Its handle becomes invalid.
+ */
+void
+TimerCenter::_release(int n) {
+	Node &node = nodes[n];
+	node.callback = nullptr;
+	++node.generation;
+	node.next = free_head;
+	free_head = n;
+}
+
+/**
+ * @brief Move all timers in the current slot of the level down to lower levels.
+ */
+void
+TimerCenter::_cascade(int level) {
+	using namespace TimerSetting;
+	int list = level * slots + static_cast<int>((now >> (slot_bits * level)) & slot_mask);
+	int n = heads[list];
+	heads[list] = -1;
+	while(n != -1) {
+		int next = nodes[n].next;
+		_insert(n);
+		n = next;
+	}
+}
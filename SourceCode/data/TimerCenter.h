@@ -0,0 +1,70 @@
+#ifndef TIMERCENTER_H_INCLUDED
+#define TIMERCENTER_H_INCLUDED
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @brief Handle of a scheduled timer. 0 is never a valid handle.
+ */
+using TimerHandle = uint64_t;
+
+/**
+ * @brief Schedules callbacks a number of ticks (frames) ahead with a hierarchical timer wheel.
+ * @details Countdowns (tower cooldowns, animation steps, coin income, monster spawns ... etc) are registered here instead of being decremented by their owners every frame. The wheel has 4 levels of 64 slots. A timer is put into the slot of the level matching how far away it is, and timers of an upper level are moved down only when their slot is reached. Scheduling and cancelling are O(1), and the work of a tick is proportional to the number of timers that fire.
+ * The wheel advances once per updated frame. A timer scheduled with delay 0 from inside a callback fires in the same tick, otherwise delay 0 is treated as 1.
+ */
+class TimerCenter
+{
+public:
+	static TimerCenter *get_instance() {
+		static TimerCenter TC;
+		return &TC;
+	}
+	TimerHandle schedule(unsigned delay, std::function<void()> callback, unsigned period = 0);
+	bool cancel(TimerHandle handle);
+	bool is_pending(TimerHandle handle) const;
+	void update();
+	uint64_t get_tick() const { return now; }
+private:
+	TimerCenter();
+	struct Node {
+		uint64_t expires;
+		unsigned period;
+		uint32_t generation;
+		int prev, next;
+		int list;
+		std::function<void()> callback;
+	};
+	int _node_of(TimerHandle handle) const;
+	void _insert(int n);
+	void _link(int n, int list);
+	void _unlink(int n);
+	void _release(int n);
+	void _cascade(int level);
+private:
+	/**
+	 * @var now
+	 * @brief Number of ticks since the game starts.
+	 **
+	 * @var nodes
+	 * @brief Pool of timers. Unused nodes are linked in free_head.
+	 **
+	 * @var heads
+	 * @brief First node of every slot list. The last list holds timers that are firing in the current tick.
+	 **
+	 * @var free_head
+	 * @brief First unused node.
+	 **
+	 * @var firing
+	 * @brief Whether update() is calling callbacks.
+	 */
+	uint64_t now;
+	std::vector<Node> nodes;
+	std::vector<int> heads;
+	int free_head;
+	bool firing;
+};
+
+#endif
@@ -6,7 +6,8 @@
 #include "../shapes/Rectangle.h"
 #include <allegro5/allegro.h> // ALLEGRO_BITMAP, al_draw_scaled_bitmap, 等 Allegro 函數
 #include <allegro5/allegro_image.h> // 加載和處理圖片的 Allegro 擴展
-#include "Rocket.h"
+#include "../projectiles/ProjectileSystem.h"
+#include "../data/ScriptCenter.h"
 
 // ./表示當前目錄 ../表示上一層
 namespace HeroSetting {
@@ -16,6 +17,32 @@ namespace HeroSetting {
 	static constexpr char gif_postfix[][10] = {
 		"left", "right", //"attack"
 	};
+	static constexpr char rocket_img_path[] = "./assets/image/rocket.png";
+	static constexpr double rocket_scale = 0.2;
+	static constexpr double rocket_speed = 200;
+	static constexpr int rocket_dmg = 8;
+	// 連發技能: 按 R 每 barrage_interval 幀發射一枚火箭，共 barrage_count 枚，之後冷卻 barrage_cooldown 幀
+	static constexpr int barrage_count = 5;
+	static constexpr unsigned barrage_interval = 6;
+	static constexpr unsigned barrage_cooldown = 300;
+	// 被動技能: 每擊殺 bounty_kills 隻怪物，免費發射一枚火箭
+	static constexpr int bounty_kills = 10;
+}
+
+static Script barrage_script(Hero *hero) {
+    for (int k = 0; k < HeroSetting::barrage_count; ++k) {
+        hero->launch_rocket();
+        co_await WaitTicks{HeroSetting::barrage_interval};
+    }
+    co_await WaitTicks{HeroSetting::barrage_cooldown};
+}
+
+static Script bounty_script(Hero *hero) {
+    while (true) {
+        for (int k = 0; k < HeroSetting::bounty_kills; ++k)
+            co_await WaitEvent{EventType::KILL};
+        hero->launch_rocket();
+    }
 }
 
 void Hero::init(int role_id){
@@ -49,6 +76,13 @@ void Hero::init(int role_id){
             HeroSetting::gif_postfix[static_cast<int>(type)]);
         gifPath[static_cast<HeroState>(type)] = std::string(buffer);
     }
+    // 火箭圖片只註冊一次，之後發射只記錄 sprite id
+    rocket_sprite = DataCenter::get_instance()->projectiles->load_sprite(HeroSetting::rocket_img_path, HeroSetting::rocket_scale);
+    // 重新選角時先停掉舊的技能 script
+    ScriptCenter *SC = ScriptCenter::get_instance();
+    SC->stop(barrage);
+    SC->stop(bounty);
+    bounty = SC->start(bounty_script(this));
     // 設定 hitbox
     DataCenter *DC = DataCenter::get_instance();
     ImageCenter *IC = ImageCenter::get_instance();
@@ -64,12 +98,12 @@ void Hero::init(int role_id){
         targetHeight = mapHeight / 5;
 
         // 使用圖片的縮放後尺寸設置 hitbox
-        shape.reset(new Rectangle(
+        shape = Rectangle(
             DC->window_width / 2 - targetWidth / 2,   // 左上角 X
             DC->window_height / 2 - targetHeight / 2, // 左上角 Y
             DC->window_width / 2 + targetWidth / 2,   // 右下角 X
             DC->window_height / 2 + targetHeight / 2  // 右下角 Y
-        ));
+        );
     }
 }
 
@@ -77,19 +111,19 @@ void Hero::update(){
     // allegro 座標系: 左上角是(0, 0)
     DataCenter *DC = DataCenter::get_instance();
     if(DC -> key_state[ALLEGRO_KEY_W]){
-        shape -> update_center_y(shape -> center_y() - speed);
+        shape.update_center_y(shape.center_y() - speed);
         state = HeroState::LEFT;
     }
     else if(DC -> key_state[ALLEGRO_KEY_A]){
-        shape -> update_center_x(shape -> center_x() - speed);
+        shape.update_center_x(shape.center_x() - speed);
         state = HeroState::LEFT;
     }
     else if(DC -> key_state[ALLEGRO_KEY_S]){
-        shape -> update_center_y(shape -> center_y() + speed);
+        shape.update_center_y(shape.center_y() + speed);
         state = HeroState::RIGHT;
     }
     else if(DC -> key_state[ALLEGRO_KEY_D]){
-        shape -> update_center_x(shape -> center_x() + speed);
+        shape.update_center_x(shape.center_x() + speed);
         state = HeroState::RIGHT;
     }
 
@@ -97,6 +131,13 @@ void Hero::update(){
         // 設定火箭發射的目標位置為當前位置向上移動一格
         launch_rocket();
     }
+
+    if (DC->key_state[ALLEGRO_KEY_R] && !(DC->prev_key_state[ALLEGRO_KEY_R])) {
+        // 技能還在施放或冷卻中就忽略
+        ScriptCenter *SC = ScriptCenter::get_instance();
+        if (!SC->is_running(barrage))
+            barrage = SC->start(barrage_script(this));
+    }
 }
 
 void Hero::draw(){
@@ -109,8 +150,8 @@ void Hero::draw(){
         al_draw_scaled_bitmap(
             image,
             0, 0, al_get_bitmap_width(image), al_get_bitmap_height(image), // 原始圖片大小
-            shape->center_x() - targetWidth / 2,                          // 左上角 X
-            shape->center_y() - targetHeight / 2,                         // 左上角 Y
+            shape.center_x() - targetWidth / 2,                          // 左上角 X
+            shape.center_y() - targetHeight / 2,                         // 左上角 Y
             targetWidth, targetHeight,                                    // 目標大小
             0 // 無翻轉
         );
@@ -118,10 +159,10 @@ void Hero::draw(){
 }
 
 void Hero::launch_rocket() {
-    Point start_position(shape->center_x(), shape->center_y());
-    Point direction(0, -1);
+    Point start_position(shape.center_x(), shape.center_y());
+    Point target(start_position.x, start_position.y - 1);
     DataCenter *DC = DataCenter::get_instance();
-    // 將火箭加入到 DataCenter 的火箭列表
-    DC->rockets.emplace_back(new Rocket(start_position, direction, "./assets/image/rocket.png", 10.0, 8, 5));
+    // 火箭往上飛，飛到螢幕最上方（y座標等於 0）就消失
+    DC->projectiles->launch(start_position, target, rocket_sprite, HeroSetting::rocket_speed, HeroSetting::rocket_dmg, start_position.y, ProjectileOwner::HERO);
 }
 
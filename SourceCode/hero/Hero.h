@@ -3,6 +3,8 @@
 //標頭檔保護 ifndef define endif
 
 #include"../Object.h"
+#include"../shapes/Rectangle.h"
+#include"../data/ScriptCenter.h"
 #include<map>
 #include<string>
 //include一些需要的標頭檔
@@ -24,12 +26,16 @@ public:
     void update();
     void draw();
     void launch_rocket();
+    Rectangle shape; // hitbox
 private:
     HeroState state = HeroState::LEFT;
     double speed = 5;
     double HP = 100;
     double attack = 10;
     int current_role_id = 1; // 當前選擇的角色 ID，預設為角色 1
+    int rocket_sprite; // 火箭在 ProjectileSystem 的 sprite id
+    ScriptId barrage = 0; // 連發技能的 script，冷卻結束前不能再次施放
+    ScriptId bounty = 0; // 被動技能的 script
     
     
     std::map<HeroState, std::string> gifPath;
@@ -0,0 +1,49 @@
+#include "BossScript.h"
+#include "MonsterSystem.h"
+#include "../data/DataCenter.h"
+#include "../data/ScriptCenter.h"
+#include "../towers/EngagementScheduler.h"
+
+// fixed settings
+namespace BossSetting {
+	constexpr unsigned regen_period = 60;
+	constexpr int regen_hp = 2;
+	// Distance (pixels) a DemonNinja walks before it calls its pack.
+	constexpr double call_dist = 240;
+	constexpr MonsterType pack_type = MonsterType::WOLF;
+	constexpr size_t pack_size = 3;
+}
+
+static Script regenerate(size_t uid) {
+	MonsterSystem *monsters = DataCenter::get_instance()->monsters;
+	while(true) {
+		co_await WaitTicks{BossSetting::regen_period};
+		monsters->heal(monsters->index(uid), BossSetting::regen_hp);
+	}
+}
+
+static Script call_pack() {
+	DataCenter *DC = DataCenter::get_instance();
+	co_await WaitPath{BossSetting::call_dist};
+	const size_t first = DC->monsters->spawn(BossSetting::pack_type, BossSetting::pack_size);
+	for(size_t i = first; i < first + BossSetting::pack_size; ++i)
+		DC->engagement->schedule_monster(i);
+}
+
+static Script shake_off(size_t uid) {
+	MonsterSystem *monsters = DataCenter::get_instance()->monsters;
+	size_t i;
+	do {
+		co_await WaitEvent{EventType::DAMAGE, uid, EventType::POISON};
+		i = monsters->index(uid);
+	} while(monsters->HP[i] * 2 > monsters->owner[i]->get_HP());
+	monsters->cleanse(i);
+}
+
+void
+start_demon_ninja(size_t uid) {
+	ScriptCenter *SC = ScriptCenter::get_instance();
+	SC->start(regenerate(uid), uid);
+	SC->start(call_pack(), uid);
+	SC->start(shake_off(uid), uid);
+}
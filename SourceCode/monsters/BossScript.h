@@ -0,0 +1,15 @@
+#ifndef BOSSSCRIPT_H_INCLUDED
+#define BOSSSCRIPT_H_INCLUDED
+
+#include <cstddef>
+
+/**
+ * @brief Start the behaviour scripts of a new DemonNinja of id uid.
+ * @details * It regenerates HP over time.
+ * @details * Once it has walked far enough, it calls a pack of wolves from the start of the road.
+ * @details * The first time damage or poison brings it below half of its HP, it shakes off all its status effects.
+ * @see MonsterInfo::scripts
+ */
+void start_demon_ninja(size_t uid);
+
+#endif
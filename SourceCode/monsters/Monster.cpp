@@ -1,174 +1,123 @@
 #include "Monster.h"
-#include "MonsterWolf.h"
-#include "MonsterCaveMan.h"
-#include "MonsterWolfKnight.h"
-#include "MonsterDemonNinja.h"
-#include "../data/DataCenter.h"
 #include "../data/ImageCenter.h"
-#include "../Level.h"
-#include "../shapes/Point.h"
-#include "../shapes/Rectangle.h"
 #include "../Utils.h"
-#include <allegro5/allegro_primitives.h>
+#include <allegro5/bitmap.h>
+#include <memory>
+#include <string>
+#include <algorithm>
 
 using namespace std;
 
 // fixed settings
-enum class Dir {
-	UP, DOWN, LEFT, RIGHT
-};
 namespace MonsterSetting {
-	static constexpr char monster_imgs_root_path[static_cast<int>(MonsterType::MONSTERTYPE_MAX)][40] = {
-		"./assets/image/monster/Wolf",
-		"./assets/image/monster/CaveMan",
-		"./assets/image/monster/WolfKnight",
-		"./assets/image/monster/DemonNinja"
-	};
 	static constexpr char dir_path_prefix[][10] = {
 		"UP", "DOWN", "LEFT", "RIGHT"
 	};
 }
 
+/**
+ * @brief The shared Monster of every MonsterType, created on first use.
+ */
+static std::array<std::unique_ptr<Monster>, static_cast<int>(MonsterType::MONSTERTYPE_MAX)> &shared_types() {
+	static std::array<std::unique_ptr<Monster>, static_cast<int>(MonsterType::MONSTERTYPE_MAX)> types;
+	return types;
+}
+
+/**
+ * @brief Largest half width and half height among the hit boxes of all move poses of all types, computed by load_types().
+ */
+static double max_half_w = 0, max_half_h = 0;
+
 /**
  * @brief Create a Monster* instance by the type.
  * @param type the type of a monster.
- * @param path walk path of the monster. The path should be represented in road grid format.
  * @return The curresponding Monster* instance.
- * @see Level::grid_to_region(const Point &grid) const
  */
-Monster *Monster::create_monster(MonsterType type, const vector<Point> &path) {
-	switch(type) {
-		case MonsterType::WOLF: {
-			return new MonsterWolf{path};
-		}
-		case MonsterType::CAVEMAN: {
-			return new MonsterCaveMan{path};
-		}
-		case MonsterType::WOLFKNIGHT: {
-			return new MonsterWolfKnight{path};
-		}
-		case MonsterType::DEMONNIJIA: {
-			return new MonsterDemonNinja{path};
-		}
-		case MonsterType::MONSTERTYPE_MAX: {}
-	}
-	GAME_ASSERT(false, "monster type error.");
+Monster *Monster::create_monster(MonsterType type) {
+	GAME_ASSERT(type < MonsterType::MONSTERTYPE_MAX, "monster type error.");
+	return get_info(type).create(type);
 }
 
 /**
- * @brief Given velocity of x and y direction, determine which direction the monster should face.
+ * @details Attributes are taken from MonsterSetting::monster_types.
  */
-Dir convert_dir(const Point &v) {
-	if(v.y < 0 && abs(v.y) >= abs(v.x))
-		return Dir::UP;
-	if(v.y > 0 && abs(v.y) >= abs(v.x))
-		return Dir::DOWN;
-	if(v.x < 0 && abs(v.x) >= abs(v.y))
-		return Dir::LEFT;
-	if(v.x > 0 && abs(v.x) >= abs(v.y))
-		return Dir::RIGHT;
-	return Dir::RIGHT;
+Monster::Monster(MonsterType type) {
+	const MonsterInfo &info = get_info(type);
+	this->type = type;
+	HP = info.HP;
+	v = info.v;
+	money = info.money;
+	bitmap_switch_freq = info.bitmap_switch_freq;
 }
 
-Monster::Monster(const vector<Point> &path, MonsterType type) {
-	DataCenter *DC = DataCenter::get_instance();
-
-	shape.reset(new Rectangle{0, 0, 0, 0});
-	this->type = type;
-	dir = Dir::RIGHT;
-	bitmap_img_id = 0;
-	bitmap_switch_counter = 0;
-	for(const Point &p : path)
-		this->path.push(p);
-	if(!path.empty()) {
-		const Point &grid = this->path.front();
-		const Rectangle &region = DC->level->grid_to_region(grid);
-		// Temporarily set the bounding box to the center (no area) since we haven't got the hit box of the monster.
-		shape.reset(new Rectangle{region.center_x(), region.center_y(), region.center_x(), region.center_y()});
-		this->path.pop();
+/**
+ * @brief Create the shared Monster of every MonsterType and load all of their move poses. Later calls do nothing.
+ * @details The largest hit box extents of all move poses are found here as well. Structures that look for monsters near a point use them to bound how far a hit box reaches from the center of its monster.
+ * @see get_max_half_w()
+ */
+void
+Monster::load_types() {
+	auto &types = shared_types();
+	for(size_t i = 0; i < types.size(); ++i) {
+		if(types[i]) continue;
+		types[i].reset(create_monster(static_cast<MonsterType>(i)));
+		types[i]->_load_frames();
+		for(const std::vector<MonsterFrame> &poses : types[i]->frames) {
+			for(const MonsterFrame &f : poses) {
+				max_half_w = max(max_half_w, f.half_w);
+				max_half_h = max(max_half_h, f.half_h);
+			}
+		}
 	}
 }
 
 /**
- * @details This update function updates the following things in order:
- * @details * Move pose of the current facing direction (bitmap_img_id).
- * @details * Current position (center of the hit box). The position is moved based on the center of the hit box (Rectangle). If the center of this monster reaches the center of the first point of path, the function will proceed to the next point of path.
- * @details * Update the real bounding box by the center of the hit box calculated as above.
+ * @brief The shared Monster of the type. load_types() must be called first.
  */
-void
-Monster::update() {
-	DataCenter *DC = DataCenter::get_instance();
-	ImageCenter *IC = ImageCenter::get_instance();
+const Monster*
+Monster::get(MonsterType type) {
+	const Monster *monster = shared_types()[static_cast<int>(type)].get();
+	GAME_ASSERT(monster != nullptr, "monster types are not loaded.");
+	return monster;
+}
 
-	// After a period, the bitmap for this monster should switch from (i)-th image to (i+1)-th image to represent animation.
-	if(bitmap_switch_counter) --bitmap_switch_counter;
-	else {
-		bitmap_img_id = (bitmap_img_id + 1) % (bitmap_img_ids[static_cast<int>(dir)].size());
-		bitmap_switch_counter = bitmap_switch_freq;
-	}
-	// v (velocity) divided by FPS is the actual moving pixels per frame.
-	double movement = v / DC->FPS;
-	// Keep trying to move to next destination in "path" while "path" is not empty and we can still move.
-	while(!path.empty() && movement > 0) {
-		const Point &grid = this->path.front();
-		const Rectangle &region = DC->level->grid_to_region(grid);
-		const Point &next_goal = Point{region.center_x(), region.center_y()};
+/**
+ * @brief Largest half width of the hit boxes of all monsters. load_types() must be called first.
+ */
+double
+Monster::get_max_half_w() {
+	return max_half_w;
+}
 
-		// Extract the next destination as "next_goal". If we want to reach next_goal, we need to move "d" pixels.
-		double d = Point::dist(Point{shape->center_x(), shape->center_y()}, next_goal);
-		Dir tmpdir;
-		if(d < movement) {
-			// If we can move more than "d" pixels in this frame, we can directly move onto next_goal and reduce "movement" by "d".
-			movement -= d;
-			tmpdir = convert_dir(Point{next_goal.x - shape->center_x(), next_goal.y - shape->center_y()});
-			shape.reset(new Rectangle{
-				next_goal.x, next_goal.y,
-				next_goal.x, next_goal.y
-		});
-			path.pop();
-		} else {
-			// Otherwise, we move exactly "movement" pixels.
-			double dx = (next_goal.x - shape->center_x()) / d * movement;
-			double dy = (next_goal.y - shape->center_y()) / d * movement;
-			tmpdir = convert_dir(Point{dx, dy});
-			shape->update_center_x(shape->center_x() + dx);
-			shape->update_center_y(shape->center_y() + dy);
-			movement = 0;
-		}
-		// Update facing direction.
-		dir = tmpdir;
-	}
-	// Update real hit box for monster.
-	char buffer[50];
-	sprintf(
-		buffer, "%s/%s_%d.png",
-		MonsterSetting::monster_imgs_root_path[static_cast<int>(type)],
-		MonsterSetting::dir_path_prefix[static_cast<int>(dir)],
-		bitmap_img_ids[static_cast<int>(dir)][bitmap_img_id]);
-	ALLEGRO_BITMAP *bitmap = IC->get(buffer);
-	const double &cx = shape->center_x();
-	const double &cy = shape->center_y();
-	// We set the hit box slightly smaller than the actual bounding box of the image because there are mostly empty spaces near the edge of a image.
-	const int &h = al_get_bitmap_width(bitmap) * 0.8;
-	const int &w = al_get_bitmap_height(bitmap) * 0.8;
-	shape.reset(new Rectangle{
-		(cx - w / 2.), (cy - h / 2.),
-		(cx - w / 2. + w), (cy - h / 2. + h)
-	});
+/**
+ * @brief Largest half height of the hit boxes of all monsters. load_types() must be called first.
+ */
+double
+Monster::get_max_half_h() {
+	return max_half_h;
 }
 
+/**
+ * @brief Load the bitmap of every move pose and compute its hit box.
+ * @details We set the hit box slightly smaller than the actual bounding box of the image because there are mostly empty spaces near the edge of a image.
+ */
 void
-Monster::draw() {
+Monster::_load_frames() {
 	ImageCenter *IC = ImageCenter::get_instance();
-	char buffer[50];
-	sprintf(
-		buffer, "%s/%s_%d.png",
-		MonsterSetting::monster_imgs_root_path[static_cast<int>(type)],
-		MonsterSetting::dir_path_prefix[static_cast<int>(dir)],
-		bitmap_img_ids[static_cast<int>(dir)][bitmap_img_id]);
-	ALLEGRO_BITMAP *bitmap = IC->get(buffer);
-	al_draw_bitmap(
-		bitmap,
-		shape->center_x() - al_get_bitmap_width(bitmap) / 2,
-		shape->center_y() - al_get_bitmap_height(bitmap) / 2, 0);
+	const MonsterInfo &info = get_info(type);
+	// Paths are `<img_root_path>/<Dir>_`, to which only the id and extension of each frame are appended.
+	string path;
+	for(size_t d = 0; d < frames.size(); ++d) {
+		path.assign(info.img_root_path).append("/").append(MonsterSetting::dir_path_prefix[d]).append("_");
+		const size_t prefix = path.size();
+		for(int id = 0; id < info.frame_count[d]; ++id) {
+			path.resize(prefix);
+			path.append(to_string(id)).append(".png");
+			ALLEGRO_BITMAP *bitmap = IC->get(path);
+			const int w = al_get_bitmap_width(bitmap);
+			const int h = al_get_bitmap_height(bitmap);
+			// As in the original hit box, the width comes from the height of the image and the height from its width.
+			frames[d].push_back(MonsterFrame{bitmap, w, h, static_cast<int>(h * 0.8) / 2., static_cast<int>(w * 0.8) / 2.});
+		}
+	}
 }
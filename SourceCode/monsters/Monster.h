@@ -1,38 +1,90 @@
 #ifndef MONSTER_H_INCLUDED
 #define MONSTER_H_INCLUDED
 
-#include "../Object.h"
-#include "../shapes/Rectangle.h"
-#include "../shapes/Point.h"
+#include "BossScript.h"
+#include <allegro5/bitmap.h>
 #include <vector>
-#include <queue>
-
-enum class Dir;
+#include <array>
+#include <string_view>
 
 // fixed settings
+enum class Dir {
+	UP, DOWN, LEFT, RIGHT
+};
 enum class MonsterType {
 	WOLF, CAVEMAN, WOLFKNIGHT, DEMONNIJIA, MONSTERTYPE_MAX
 };
 
+/**
+ * @brief A move pose of a monster and the hit box it implies.
+ */
+struct MonsterFrame {
+	ALLEGRO_BITMAP *bitmap;
+	int w, h;
+	double half_w, half_h;
+};
+
+class Monster;
+
+/**
+ * @brief Everything that defines a MonsterType.
+ **
+ * @var img_root_path
+ * @brief Move poses are `<img_root_path>/<Dir>_<ordered_id>.png`.
+ **
+ * @var frame_count
+ * @brief Number of move poses of each Dir.
+ **
+ * @var create
+ * @brief Creates the Monster of the type. Types with special behaviour point it to a subclass of Monster.
+ **
+ * @var scripts
+ * @brief Starts the behaviour scripts of a new monster of the type by its id, or nullptr if the type has none.
+ * @see ScriptCenter
+ */
+struct MonsterInfo {
+	std::string_view img_root_path;
+	int HP;
+	int v;
+	int money;
+	int bitmap_switch_freq;
+	std::array<int, 4> frame_count;
+	Monster *(*create)(MonsterType type);
+	void (*scripts)(size_t uid);
+};
+
 /**
  * @brief The class of a monster (enemies).
- * @details Monster inherits Object and takes Rectangle as its hit box.
+ * @details Monster only stores the attributes that do not change while the monster walks (money, speed, animation poses ... etc). Position, HP and other per-frame states are stored in MonsterSystem.
+ * There is only one Monster object of each MonsterType, created by load_types() and shared by all monsters of the type.
+ * @see MonsterSystem
  */
-class Monster : public Object
+class Monster
 {
 public:
-	static Monster *create_monster(MonsterType type, const std::vector<Point> &path);
+	static Monster *create_monster(MonsterType type);
+	static const MonsterInfo &get_info(MonsterType type);
+	static void load_types();
+	static const Monster *get(MonsterType type);
+	static double get_max_half_w();
+	static double get_max_half_h();
 public:
-	Monster(const std::vector<Point> &path, MonsterType type);
-	void update();
-	void draw();
+	Monster(MonsterType type);
+	virtual ~Monster() {}
+	ALLEGRO_BITMAP *get_bitmap(Dir dir, int frame) const { return get_frame(dir, frame).bitmap; }
+	const MonsterFrame &get_frame(Dir dir, int frame) const { return frames[static_cast<int>(dir)][frame]; }
+	MonsterType get_type() const { return type; }
+	const int &get_HP() const { return HP; }
+	const int &get_v() const { return v; }
 	const int &get_money() const { return money; }
-	int HP;
-	const std::queue<Point> &get_path() const { return path; }
+	const int &get_bitmap_switch_freq() const { return bitmap_switch_freq; }
+	int get_frame_count(Dir dir) const { return frames[static_cast<int>(dir)].size(); }
+private:
+	void _load_frames();
 protected:
 	/**
 	 * @var HP
-	 * @brief Health point of a monster.
+	 * @brief Initial health point of a monster.
 	 **
 	 * @var v
 	 * @brief Moving speed of a monster.
@@ -40,38 +92,46 @@ protected:
 	 * @var money
 	 * @brief The amount of money that player will earn when the monster is killed.
 	 **
-	 * @var bitmap_img_ids
-	 * @brief The first vector is the Dir index, and the second vector is image id.
-	 * @details `bitmap_img_ids[Dir][<ordered_id>]`
-	 **
-	 * @var bitmap_switch_counter
-	 * @brief Counting down for bitmap_switch_freq.
-	 * @see Monster::bitmap_switch_freq
-	 **
 	 * @var bitmap_switch_freq
 	 * @brief Number of frames required to change to the next move pose for the current facing direction.
-	 * @details The variable is left for child classes to define.
-	 * 
-	 * @var bitmap_img_id
-	 * @brief Move pose of the current facing direction.
-	 **
-	 * @var dir
-	 * @brief Current facing direction.
-	 **
-	 * @var path
-	 * @brief The walk path of a monster, represented in grid format.
-	 * @see Level::grid_to_region(const Point &grid) const
 	*/
+	int HP;
 	int v;
 	int money;
-	std::vector<std::vector<int>> bitmap_img_ids;
-	int bitmap_switch_counter;
 	int bitmap_switch_freq;
-	int bitmap_img_id;
 private:
 	MonsterType type;
-	Dir dir;
-	std::queue<Point> path;
+	/**
+	 * @brief Move poses of each direction. `frames[Dir][<ordered_id>]`
+	 */
+	std::array<std::vector<MonsterFrame>, 4> frames;
 };
 
+/**
+ * @brief Factory of MonsterInfo::create.
+ */
+template<typename T>
+Monster *make_monster(MonsterType type) {
+	return new T(type);
+}
+
+// fixed settings
+namespace MonsterSetting {
+	/**
+	 * @brief MonsterInfo of every MonsterType, indexed by the type. A new type only needs a new row here.
+	 */
+	inline constexpr std::array<MonsterInfo, static_cast<int>(MonsterType::MONSTERTYPE_MAX)> monster_types = {{
+		// image root, HP, speed, money, pose switch freq, poses of {UP, DOWN, LEFT, RIGHT}, factory, scripts
+		{"./assets/image/monster/Wolf", 10, 60, 10, 20, {4, 4, 5, 5}, make_monster<Monster>, nullptr},
+		{"./assets/image/monster/CaveMan", 25, 40, 20, 20, {4, 4, 4, 4}, make_monster<Monster>, nullptr},
+		{"./assets/image/monster/WolfKnight", 15, 80, 30, 20, {4, 4, 4, 4}, make_monster<Monster>, nullptr},
+		{"./assets/image/monster/DemonNinja", 50, 60, 40, 20, {4, 4, 4, 4}, make_monster<Monster>, start_demon_ninja}
+	}};
+}
+
+inline const MonsterInfo&
+Monster::get_info(MonsterType type) {
+	return MonsterSetting::monster_types[static_cast<int>(type)];
+}
+
 #endif
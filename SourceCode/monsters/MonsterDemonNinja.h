@@ -1,22 +0,0 @@
-#ifndef MONSTERDEMONNINJA_H_INCLUDED
-#define MONSTERDEMONNINJA_H_INCLUDED
-
-#include "Monster.h"
-
-// fixed settings: MonsterDemonNinja attributes
-class MonsterDemonNinja : public Monster
-{
-public:
-	MonsterDemonNinja(const std::vector<Point> &path) : Monster{path, MonsterType::DEMONNIJIA} {
-		HP = 50;
-		v = 60;
-		money = 40;
-		bitmap_img_ids.emplace_back(std::vector<int>({0, 1, 2, 3})); // UP
-		bitmap_img_ids.emplace_back(std::vector<int>({0, 1, 2, 3})); // DOWN
-		bitmap_img_ids.emplace_back(std::vector<int>({0, 1, 2, 3})); // LEFT
-		bitmap_img_ids.emplace_back(std::vector<int>({0, 1, 2, 3})); // RIGHT
-		bitmap_switch_freq = 20;
-	}
-};
-
-#endif
@@ -0,0 +1,481 @@
+#include "MonsterSystem.h"
+#include "../data/DataCenter.h"
+#include "../Level.h"
+#include "../shapes/Point.h"
+#include "../shapes/Rectangle.h"
+#include "../Utils.h"
+#include "../data/TimerCenter.h"
+#include "../data/EventCenter.h"
+#include "../data/ScriptCenter.h"
+#include "../towers/EngagementScheduler.h"
+#include <allegro5/bitmap_draw.h>
+#include <allegro5/drawing.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+// fixed settings
+namespace MonsterSystemSetting {
+	// Animation phases of consecutive monster ids differ by this number of ticks.
+	constexpr unsigned anim_phase_step = 7;
+	// Level of detail of drawing.
+	constexpr size_t lod_slow_count = 1000;
+	constexpr int lod_slow_rate = 4;
+	constexpr size_t lod_still_count = 5000;
+}
+
+/**
+ * @brief Given velocity of x and y direction, determine which direction the monster should face.
+ */
+static Dir convert_dir(double vx, double vy) {
+	if(vy < 0 && abs(vy) >= abs(vx))
+		return Dir::UP;
+	if(vy > 0 && abs(vy) >= abs(vx))
+		return Dir::DOWN;
+	if(vx < 0 && abs(vx) >= abs(vy))
+		return Dir::LEFT;
+	if(vx > 0 && abs(vx) >= abs(vy))
+		return Dir::RIGHT;
+	return Dir::RIGHT;
+}
+
+/**
+ * @brief Advance n monsters along the road by their speed and pace for dt seconds. Monsters stop at the end of the road.
+ * @details The loop has no branch and the arrays do not overlap, so the compiler is able to vectorize it.
+ */
+static void advance_kernel(
+	size_t n, double dt, double length,
+	double *__restrict dist, const double *__restrict speed, const double *__restrict pace) {
+	for(size_t i = 0; i < n; ++i)
+		dist[i] = min(dist[i] + speed[i] * pace[i] * dt, length);
+}
+
+/**
+ * @brief Length of the road the monsters walk on. Routes on an open map may change at any time, so the length is infinite there.
+ */
+static double road_length(const Level *level) {
+	if(level->is_open_map()) return numeric_limits<double>::infinity();
+	return level->get_road_polyline().length();
+}
+
+/**
+ * @brief Create the centers that clear() uses before the monsters, so that they are destroyed after the monsters when the program exits.
+ */
+MonsterSystem::MonsterSystem() {
+	TimerCenter::get_instance();
+	ScriptCenter::get_instance();
+}
+
+MonsterSystem::~MonsterSystem() {
+	clear();
+}
+
+/**
+ * @brief Create a monster of the type at the start of the road path.
+ * @details The monster is placed at the center of the first point of path, facing the second point of path. Behaviour scripts of the type, if any, are started once the monster is in place.
+ * @return Index of the new monster.
+ * @see Level::get_road_polyline()
+ */
+size_t
+MonsterSystem::spawn(MonsterType type) {
+	DataCenter *DC = DataCenter::get_instance();
+	const RoadPolyline &poly = DC->level->get_road_polyline();
+	const Monster *monster = Monster::get(type);
+	path_length = road_length(DC->level);
+
+	size_t i = owner.size();
+	x.emplace_back(0);
+	y.emplace_back(0);
+	speed.emplace_back(monster->get_v());
+	pace.emplace_back(1);
+	dist.emplace_back(0);
+	seg.emplace_back(0);
+	wcell.emplace_back(DC->level->is_open_map() ? DC->level->get_start_cell() : -1);
+	HP.emplace_back(monster->get_HP());
+	dir.emplace_back(Dir::RIGHT);
+	half_w.emplace_back(0);
+	half_h.emplace_back(0);
+	dead.emplace_back(false);
+	poison.emplace_back(0);
+	effects.emplace_back();
+	owner.emplace_back(monster);
+	size_t id = index_of.size();
+	if(!free_uids.empty()) {
+		id = free_uids.back();
+		free_uids.pop_back();
+	} else index_of.emplace_back(0);
+	index_of[id] = i;
+	uid.emplace_back(id);
+	// Monsters spawned in the same frame start at different points of the animation, spread by their id.
+	const unsigned period = monster->get_bitmap_switch_freq() + 1;
+	anim_phase.emplace_back(TimerCenter::get_instance()->get_tick() - id * MonsterSystemSetting::anim_phase_step % period);
+	if(!poly.s.empty()) {
+		x[i] = poly.x[0];
+		y[i] = poly.y[0];
+		if(DC->level->is_open_map()) _steer(i, 0);
+		else _locate(i, poly);
+	}
+	_update_hitbox(i, TimerCenter::get_instance()->get_tick());
+	if(Monster::get_info(type).scripts) Monster::get_info(type).scripts(id);
+	return i;
+}
+
+/**
+ * @brief Spawn count monsters of the same type at the start of the road.
+ * @details All arrays grow once for the whole batch instead of once per monster.
+ * @return Index of the first spawned monster. The batch occupies count consecutive indices.
+ */
+size_t
+MonsterSystem::spawn(MonsterType type, size_t count) {
+	size_t first = owner.size();
+	if(first + count > owner.capacity()) {
+		// keep the geometric growth so that many small batches stay amortized constant
+		size_t n = std::max(first + count, owner.capacity() * 2);
+		x.reserve(n); y.reserve(n);
+		speed.reserve(n);
+		pace.reserve(n);
+		dist.reserve(n);
+		seg.reserve(n);
+		wcell.reserve(n);
+		HP.reserve(n);
+		dir.reserve(n);
+		anim_phase.reserve(n);
+		uid.reserve(n);
+		half_w.reserve(n); half_h.reserve(n);
+		dead.reserve(n);
+		poison.reserve(n);
+		effects.reserve(n);
+		owner.reserve(n);
+	}
+	for(size_t k = 0; k < count; ++k)
+		spawn(type);
+	return first;
+}
+
+/**
+ * @details This update function updates the following things in order:
+ * @details * Distance travelled. Every monster moves along the road by its speed in one loop over the distance array.
+ * @details * Current position (center of the hit box) and facing direction, looked up from the polyline segment at the distance travelled. On an open map, monsters move toward the next grid of the flow field instead.
+ * @details * Rebuild the broadphase grid with the new hit boxes.
+ * @details Move poses are not stored. They are derived from the tick of TimerCenter, so only the hit box of the current move pose is looked up here.
+ * @details The update could also be split into begin_update(), update_range() on disjoint ranges of monsters (possibly on different threads), and end_update().
+ */
+void
+MonsterSystem::update() {
+	begin_update();
+	update_range(0, size());
+	end_update();
+}
+
+void
+MonsterSystem::begin_update() {
+	path_length = road_length(DataCenter::get_instance()->level);
+}
+
+/**
+ * @brief Move the monsters of indices [begin, end). Only data of these monsters is written.
+ * @details Monsters reaching the end are reported to EventCenter, which decides whether they leak. On a poison pulse, the poison damage of the monsters is sent to EventCenter as well.
+ */
+void
+MonsterSystem::update_range(size_t begin, size_t end) {
+	DataCenter *DC = DataCenter::get_instance();
+	const RoadPolyline &poly = DC->level->get_road_polyline();
+
+	// v (velocity) divided by FPS is the actual moving pixels per frame.
+	advance_kernel(end - begin, 1 / DC->FPS, path_length, dist.data() + begin, speed.data() + begin, pace.data() + begin);
+
+	if(DC->level->is_open_map()) {
+		for(size_t i = begin; i < end; ++i)
+			_steer(i, speed[i] * pace[i] / DC->FPS);
+	} else if(!poly.s.empty()) {
+		for(size_t i = begin; i < end; ++i)
+			_locate(i, poly);
+	}
+	EventCenter *EC = EventCenter::get_instance();
+	for(size_t i = begin; i < end; ++i)
+		if(reached_end(i)) EC->emit(EventType::ARRIVE, i, i, 0);
+	const uint64_t now = TimerCenter::get_instance()->get_tick();
+	if(now % EffectSetting::poison_period == 0) {
+		for(size_t i = begin; i < end; ++i)
+			if(poison[i] > 0) EC->emit(EventType::POISON, i, i, poison[i]);
+	}
+	for(size_t i = begin; i < end; ++i)
+		_update_hitbox(i, now);
+}
+
+void
+MonsterSystem::end_update() {
+	DataCenter *DC = DataCenter::get_instance();
+	grid.reset(DC->game_field_length, DC->level->get_grid_size());
+	grid.build(size(), x.data(), y.data(), half_w.data(), half_h.data());
+}
+
+/**
+ * @brief Move pose of the i-th monster at the tick, if move poses are switched once every rate periods.
+ * @details The pose switches every Monster::get_bitmap_switch_freq() + 1 ticks, counted from the animation phase of the monster.
+ */
+int
+MonsterSystem::frame_of(size_t i, uint64_t tick, int rate) const {
+	const Monster *monster = owner[i];
+	const uint64_t period = static_cast<uint64_t>(monster->get_bitmap_switch_freq() + 1) * rate;
+	return (tick - anim_phase[i]) / period % monster->get_frame_count(dir[i]);
+}
+
+/**
+ * @brief Put the status effect on the i-th monster.
+ * @details The effect takes an empty slot while the monster carries fewer instances of it than EffectInfo::stacks. Otherwise it replaces the instance of the effect that expires first, or, if the buffer is full, the effect of any kind that expires first.
+ * @param effect effect id of EffectSetting::effect_types.
+ */
+void
+MonsterSystem::apply_effect(size_t i, int effect) {
+	using namespace EffectSetting;
+	const EffectInfo &info = effect_types[effect];
+	TimerCenter *TC = TimerCenter::get_instance();
+	EffectSlots &slots = effects[i];
+	int same = 0;
+	for(int s = 0; s < slot_count; ++s)
+		same += (slots.effect[s] == effect);
+	const bool stack = same < info.stacks;
+	int slot = -1;
+	for(int s = 0; s < slot_count; ++s) {
+		if(stack && slots.effect[s] == none) {
+			slot = s;
+			break;
+		}
+		if(!stack && slots.effect[s] != effect) continue;
+		if(slot == -1 || slots.until[s] < slots.until[slot]) slot = s;
+	}
+	TC->cancel(slots.timer[slot]);
+	slots.effect[slot] = effect;
+	slots.until[slot] = TC->get_tick() + info.duration;
+	// Timers find the monster by its id, which does not change when other monsters are removed.
+	slots.timer[slot] = TC->schedule(info.duration, [this, id = uid[i], slot]() { _expire_effect(id, slot); });
+	_refresh_effects(i);
+}
+
+/**
+ * @brief Remove all status effects from the i-th monster.
+ */
+void
+MonsterSystem::cleanse(size_t i) {
+	TimerCenter *TC = TimerCenter::get_instance();
+	EffectSlots &slots = effects[i];
+	for(int s = 0; s < EffectSetting::slot_count; ++s) {
+		TC->cancel(slots.timer[s]);
+		slots.effect[s] = EffectSetting::none;
+		slots.timer[s] = 0;
+	}
+	_refresh_effects(i);
+}
+
+/**
+ * @brief Restore HP of the i-th monster by amount, up to the HP of its type.
+ */
+void
+MonsterSystem::heal(size_t i, int amount) {
+	HP[i] = min(HP[i] + amount, owner[i]->get_HP());
+}
+
+/**
+ * @brief Tick at which the last stun on the i-th monster expires, or 0 if it is not stunned.
+ */
+uint64_t
+MonsterSystem::stunned_until(size_t i) const {
+	uint64_t res = 0;
+	for(int s = 0; s < EffectSetting::slot_count; ++s) {
+		const int effect = effects[i].effect[s];
+		if(effect != EffectSetting::none && EffectSetting::effect_types[effect].type == EffectType::STUN)
+			res = max(res, effects[i].until[s]);
+	}
+	return res;
+}
+
+void
+MonsterSystem::_expire_effect(size_t id, int slot) {
+	const size_t i = index_of[id];
+	effects[i].effect[slot] = EffectSetting::none;
+	effects[i].timer[slot] = 0;
+	_refresh_effects(i);
+}
+
+/**
+ * @brief Recompute pace and poison of the i-th monster from its effects.
+ * @details If the pace changes, the predicted engagements of the monster no longer hold, so it is scheduled again by EngagementScheduler.
+ */
+void
+MonsterSystem::_refresh_effects(size_t i) {
+	int dmg = 0;
+	double p = 1;
+	bool stunned = false;
+	for(int effect : effects[i].effect) {
+		if(effect == EffectSetting::none) continue;
+		const EffectInfo &info = EffectSetting::effect_types[effect];
+		switch(info.type) {
+			case EffectType::POISON: dmg += info.power; break;
+			case EffectType::SLOW: p = min(p, info.power / 100.); break;
+			case EffectType::STUN: stunned = true; break;
+		}
+	}
+	poison[i] = dmg;
+	if(stunned) p = 0;
+	if(p == pace[i]) return;
+	pace[i] = p;
+	DataCenter::get_instance()->engagement->reschedule_monster(i);
+}
+
+/**
+ * @details Drawing uses a level of detail depending on the number of monsters, which only changes what is drawn and never the hit boxes:
+ * @details * Monsters outside the game field are not drawn.
+ * @details * Above lod_slow_count monsters, move poses switch lod_slow_rate times slower.
+ * @details * Above lod_still_count monsters, every monster is drawn with the first move pose of its direction. Consecutive monsters then mostly share bitmaps, which Allegro draws in one batch.
+ */
+void
+MonsterSystem::draw() {
+	using namespace MonsterSystemSetting;
+	DataCenter *DC = DataCenter::get_instance();
+	const uint64_t now = TimerCenter::get_instance()->get_tick();
+	const double field = DC->game_field_length;
+	const bool still = size() > lod_still_count;
+	const int rate = size() > lod_slow_count ? lod_slow_rate : 1;
+	al_hold_bitmap_drawing(true);
+	for(size_t i = 0; i < size(); ++i) {
+		const MonsterFrame &f = owner[i]->get_frame(dir[i], still ? 0 : frame_of(i, now, rate));
+		const double x1 = x[i] - f.w / 2, y1 = y[i] - f.h / 2;
+		if(x1 >= field || y1 >= field || x1 + f.w <= 0 || y1 + f.h <= 0) continue;
+		al_draw_bitmap(f.bitmap, x1, y1, 0);
+	}
+	al_hold_bitmap_drawing(false);
+}
+
+/**
+ * @brief Remove all monsters marked dead in one pass. The order of the other monsters is kept.
+ * @details Scripts of the removed monsters are stopped before their ids are reused.
+ */
+void
+MonsterSystem::compact() {
+	if(dead_count == 0) return;
+	TimerCenter *TC = TimerCenter::get_instance();
+	ScriptCenter *SC = ScriptCenter::get_instance();
+	for(size_t i = 0; i < size(); ++i) {
+		if(!dead[i]) continue;
+		SC->remove_monster(uid[i]);
+		index_of[uid[i]] = -1;
+		free_uids.emplace_back(uid[i]);
+		for(TimerHandle timer : effects[i].timer)
+			TC->cancel(timer);
+	}
+	compact_marked(x, dead);
+	compact_marked(y, dead);
+	compact_marked(speed, dead);
+	compact_marked(pace, dead);
+	compact_marked(dist, dead);
+	compact_marked(seg, dead);
+	compact_marked(wcell, dead);
+	compact_marked(HP, dead);
+	compact_marked(dir, dead);
+	compact_marked(anim_phase, dead);
+	compact_marked(uid, dead);
+	compact_marked(half_w, dead);
+	compact_marked(half_h, dead);
+	compact_marked(poison, dead);
+	compact_marked(effects, dead);
+	compact_marked(owner, dead);
+	dead.assign(owner.size(), false);
+	dead_count = 0;
+	for(size_t i = 0; i < size(); ++i)
+		index_of[uid[i]] = i;
+}
+
+void
+MonsterSystem::clear() {
+	TimerCenter *TC = TimerCenter::get_instance();
+	for(const EffectSlots &slots : effects) {
+		for(TimerHandle timer : slots.timer)
+			TC->cancel(timer);
+	}
+	for(size_t id : uid)
+		ScriptCenter::get_instance()->remove_monster(id);
+	x.clear(); y.clear();
+	speed.clear();
+	pace.clear();
+	dist.clear();
+	seg.clear();
+	wcell.clear();
+	HP.clear();
+	dir.clear();
+	anim_phase.clear();
+	uid.clear();
+	index_of.clear();
+	free_uids.clear();
+	half_w.clear(); half_h.clear();
+	dead.clear();
+	poison.clear();
+	effects.clear();
+	owner.clear();
+	dead_count = 0;
+}
+
+/**
+ * @brief Move the segment cursor of the i-th monster forward to the segment containing its distance travelled, then set its position and facing direction.
+ * @details Segments are only passed forward, so the cursor moves by at most a few segments per tick. Zero-length segments and the end of the road keep the current facing direction.
+ */
+void
+MonsterSystem::_locate(size_t i, const RoadPolyline &poly) {
+	size_t k = seg[i];
+	while(k + 1 < poly.s.size() && dist[i] >= poly.s[k + 1]) ++k;
+	seg[i] = k;
+	double t = dist[i] - poly.s[k];
+	x[i] = poly.x[k] + poly.ux[k] * t;
+	y[i] = poly.y[k] + poly.uy[k] * t;
+	_face(i, poly.ux[k], poly.uy[k]);
+}
+
+/**
+ * @brief Move the i-th monster on an open map toward its next grid (wcell) by the movement. Reached grids are replaced by their next grid in the flow field.
+ * @details The monster reaches the end when it arrives at the goal.
+ */
+void
+MonsterSystem::_steer(size_t i, double movement) {
+	DataCenter *DC = DataCenter::get_instance();
+	const FlowField &flow = DC->level->get_flow_field();
+	while(!reached_end(i)) {
+		const Rectangle &region = DC->level->grid_to_region(DC->level->cell_to_grid(wcell[i]));
+		const Vec2 &delta = Vec2{region.center_x(), region.center_y()} - Vec2{x[i], y[i]};
+		double d = delta.length();
+		if(d > movement) {
+			x[i] += delta.x / d * movement;
+			y[i] += delta.y / d * movement;
+			_face(i, delta.x, delta.y);
+			return;
+		}
+		x[i] = region.center_x();
+		y[i] = region.center_y();
+		movement -= d;
+		if(wcell[i] == flow.get_goal() || flow.next(wcell[i]) == -1) {
+			dist[i] = path_length;
+			return;
+		}
+		wcell[i] = flow.next(wcell[i]);
+	}
+}
+
+/**
+ * @brief Turn the i-th monster to face the direction (dx, dy). A zero direction keeps the current facing direction.
+ */
+void
+MonsterSystem::_face(size_t i, double dx, double dy) {
+	if(dx == 0 && dy == 0) return;
+	dir[i] = convert_dir(dx, dy);
+}
+
+/**
+ * @brief Update the hit box extents of the i-th monster from its move pose at the tick.
+ */
+void
+MonsterSystem::_update_hitbox(size_t i, uint64_t tick) {
+	const MonsterFrame &f = owner[i]->get_frame(dir[i], frame_of(i, tick));
+	half_w[i] = f.half_w;
+	half_h[i] = f.half_h;
+}
@@ -0,0 +1,181 @@
+#ifndef MONSTERSYSTEM_H_INCLUDED
+#define MONSTERSYSTEM_H_INCLUDED
+
+#include "Monster.h"
+#include "StatusEffect.h"
+#include "../shapes/Rectangle.h"
+#include "../shapes/Circle.h"
+#include "../shapes/SpatialGrid.h"
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+struct RoadPolyline;
+
+/**
+ * @brief Stores all walking monsters in structure-of-arrays layout.
+ * @details The i-th element of every array belongs to the i-th monster, and the order of monsters is the order they spawned. Per-frame states (distance travelled, position, HP, animation frame and hit box) are kept in contiguous arrays so that the movement step of all monsters can run as one tight loop.
+ * All monsters walk on the same RoadPolyline of the level, so a monster only stores how far it has travelled. Its position and facing direction are looked up from the segment it is on.
+ * On an open map, monsters instead follow the FlowField of the level from grid to grid, and only store the grid they are heading to.
+ * The constant attributes of a monster are kept in the Monster object of its type (owner), shared by all monsters of the type and only read when a monster is spawned, killed, drawn or changes its move pose.
+ * Status effects of a monster are kept in a fixed-capacity buffer (effects) and removed by timers of TimerCenter. Their combined result is cached in pace and poison whenever an effect is put or expires, so the movement loop only multiplies by pace, and poison is one extra pass per poison pulse.
+ * @see Monster
+ */
+class MonsterSystem
+{
+public:
+	MonsterSystem();
+	~MonsterSystem();
+	size_t spawn(MonsterType type);
+	size_t spawn(MonsterType type, size_t count);
+	void update();
+	void begin_update();
+	void update_range(size_t begin, size_t end);
+	void end_update();
+	void draw();
+	void mark_dead(size_t i) {
+		if(!dead[i]) dead[i] = true, ++dead_count;
+	}
+	bool is_dead(size_t i) const { return dead[i]; }
+	/**
+	 * @brief Current index of the monster of id, or -1 if it has been removed.
+	 */
+	size_t index(size_t id) const { return index_of[id]; }
+	void compact();
+	void clear();
+	size_t size() const { return owner.size(); }
+	bool empty() const { return owner.empty(); }
+	Rectangle hitbox(size_t i) const {
+		return Rectangle{x[i] - half_w[i], y[i] - half_h[i], x[i] + half_w[i], y[i] + half_h[i]};
+	}
+	bool reached_end(size_t i) const { return dist[i] >= path_length; }
+	/**
+	 * @brief Whether the i-th monster is further along the road path than the j-th monster.
+	 */
+	bool is_ahead(size_t i, size_t j) const { return dist[i] > dist[j]; }
+	int frame_of(size_t i, uint64_t tick, int rate = 1) const;
+	/**
+	 * @brief Call f(i) for every live monster i whose hit box overlaps the circle.
+	 * @details Backed by the broadphase grid, so it is only valid between end_update() and the next compact().
+	 */
+	template<typename F>
+	void for_each_in_radius(const Circle &c, F &&f) const {
+		grid.query_overlap(c, [&](size_t i) {
+			if(!dead[i]) f(i);
+		});
+	}
+	/**
+	 * @brief Find up to k live monsters nearest to (x, y) within max_r that are not rejected by skip(i).
+	 * @details Backed by the broadphase grid, so it is only valid between end_update() and the next compact().
+	 * @see SpatialGrid::nearest()
+	 */
+	template<typename F>
+	size_t nearest(double x, double y, double max_r, size_t k, std::pair<double, size_t> *out, F &&skip) const {
+		return grid.nearest(x, y, max_r, k, out, [&](size_t i) { return dead[i] || skip(i); });
+	}
+	void apply_effect(size_t i, int effect);
+	void cleanse(size_t i);
+	void heal(size_t i, int amount);
+	uint64_t stunned_until(size_t i) const;
+public:
+	/**
+	 * @var x
+	 * @brief Center of the hit box in x direction.
+	 **
+	 * @var y
+	 * @brief Center of the hit box in y direction.
+	 **
+	 * @var speed
+	 * @brief Moving speed (pixels per second), copied from Monster::get_v().
+	 **
+	 * @var pace
+	 * @brief Fraction of speed the monster actually moves with under its status effects: 1 normally, lower when slowed, and 0 when stunned.
+	 **
+	 * @var dist
+	 * @brief Distance travelled along the road polyline. If it reaches the length of the polyline, the monster has reached the end.
+	 * @details On an open map, the polyline has infinite length and dist is set to infinity when the monster reaches the goal.
+	 **
+	 * @var seg
+	 * @brief Index of the polyline segment the monster is on.
+	 **
+	 * @var wcell
+	 * @brief On an open map, the grid the monster is heading to.
+	 **
+	 * @var HP
+	 * @brief Health point of a monster.
+	 **
+	 * @var dir
+	 * @brief Current facing direction.
+	 **
+	 * @var anim_phase
+	 * @brief Tick the animation of the monster counts from. The move pose of the current facing direction is given by frame_of().
+	 **
+	 * @var uid
+	 * @brief Id of the monster that does not change when other monsters are removed. Timer callbacks could find the monster by its id.
+	 **
+	 * @var half_w
+	 * @brief Half width of the hit box.
+	 **
+	 * @var half_h
+	 * @brief Half height of the hit box.
+	 **
+	 * @var dead
+	 * @brief Whether the monster is marked to be removed by the next compact().
+	 **
+	 * @var poison
+	 * @brief Damage the monster takes on every poison pulse, summed over its poison stacks.
+	 **
+	 * @var effects
+	 * @brief Status effects on the monster.
+	 **
+	 * @var owner
+	 * @brief Constant attributes of the type of the monster, including its move poses and their hit boxes.
+	 **
+	 * @var grid
+	 * @brief Broadphase grid of the hit boxes, rebuilt at the end of every update().
+	 * @details Item indices are monster indices, so the grid is only valid until the next compact().
+	 */
+	std::vector<double> x, y;
+	std::vector<double> speed;
+	std::vector<double> pace;
+	std::vector<double> dist;
+	std::vector<size_t> seg;
+	std::vector<int> wcell;
+	std::vector<int> HP;
+	std::vector<Dir> dir;
+	std::vector<uint64_t> anim_phase;
+	std::vector<size_t> uid;
+	std::vector<double> half_w, half_h;
+	std::vector<char> dead;
+	std::vector<int> poison;
+	std::vector<EffectSlots> effects;
+	std::vector<const Monster*> owner;
+	SpatialGrid grid;
+private:
+	void _locate(size_t i, const RoadPolyline &poly);
+	void _steer(size_t i, double movement);
+	void _face(size_t i, double dx, double dy);
+	void _update_hitbox(size_t i, uint64_t tick);
+	void _expire_effect(size_t id, int slot);
+	void _refresh_effects(size_t i);
+	/**
+	 * @var index_of
+	 * @brief Current index of each monster id, or -1 if the id is not used.
+	 **
+	 * @var free_uids
+	 * @brief Ids of removed monsters, reused by the next spawned monsters.
+	 */
+	std::vector<size_t> index_of;
+	std::vector<size_t> free_uids;
+	/**
+	 * @brief Length of the road polyline the monsters are walking on.
+	 */
+	double path_length = 0;
+	/**
+	 * @brief Number of monsters marked dead.
+	 */
+	size_t dead_count = 0;
+};
+
+#endif
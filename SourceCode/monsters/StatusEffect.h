@@ -0,0 +1,75 @@
+#ifndef STATUSEFFECT_H_INCLUDED
+#define STATUSEFFECT_H_INCLUDED
+
+#include "../data/TimerCenter.h"
+#include <array>
+#include <cstdint>
+
+// fixed settings
+enum class EffectType {
+	POISON, SLOW, STUN
+};
+
+/**
+ * @brief Everything that defines a status effect put on monsters by tower bullets.
+ **
+ * @var power
+ * @brief POISON: damage of every poison pulse. SLOW: speed in percent of the normal speed. STUN: unused.
+ **
+ * @var duration
+ * @brief Number of ticks the effect lasts.
+ **
+ * @var stacks
+ * @brief Number of instances of the effect a monster may carry at once. Applying the effect once more refreshes the instance that expires first.
+ */
+struct EffectInfo {
+	EffectType type;
+	int power;
+	unsigned duration;
+	int stacks;
+};
+
+namespace EffectSetting {
+	/**
+	 * @brief EffectInfo of every effect, indexed by effect id.
+	 * @details Stacking rules: poison stacks add up, the strongest slow decides the speed, and a stun stops the monster regardless of slows.
+	 */
+	inline constexpr std::array<EffectInfo, 3> effect_types = {{
+		// type, power, duration, stacks
+		{EffectType::POISON, 3, 180, 3},
+		{EffectType::SLOW, 50, 60, 1},
+		{EffectType::STUN, 0, 20, 1}
+	}};
+	// Effect ids of effect_types, or -1 for no effect.
+	constexpr int none = -1, poison = 0, slow = 1, stun = 2;
+	// Poison deals its damage once every poison_period ticks.
+	constexpr unsigned poison_period = 30;
+	// Number of effects a monster carries at most. A new effect on a full monster replaces the one that expires first.
+	constexpr int slot_count = 4;
+}
+
+/**
+ * @brief Fixed-capacity buffer of the status effects on one monster.
+ * @details Every slot holds one instance of an effect and the timer of TimerCenter that removes it, so effects expire without being scanned every tick.
+ **
+ * @var effect
+ * @brief Effect id of each slot, or -1 if the slot is empty.
+ **
+ * @var until
+ * @brief Tick at which the effect of each slot expires.
+ **
+ * @var timer
+ * @brief Timer removing the effect of each slot.
+ */
+struct EffectSlots {
+	std::array<int8_t, EffectSetting::slot_count> effect;
+	std::array<uint64_t, EffectSetting::slot_count> until;
+	std::array<TimerHandle, EffectSetting::slot_count> timer;
+	EffectSlots() {
+		effect.fill(EffectSetting::none);
+		until.fill(0);
+		timer.fill(0);
+	}
+};
+
+#endif
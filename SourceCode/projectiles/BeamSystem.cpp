@@ -0,0 +1,104 @@
+#include "BeamSystem.h"
+#include "ProjectileSystem.h"
+#include "../data/ImageCenter.h"
+#include "../data/TimerCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../shapes/Point.h"
+#include <allegro5/bitmap_draw.h>
+#include <cmath>
+
+using namespace std;
+
+// fixed settings
+namespace BeamSetting {
+	// Number of frames a beam stays on the screen.
+	constexpr uint64_t lifetime = 8;
+	// Events of beams are keyed from here, apart from the keys of projectiles.
+	constexpr size_t event_key = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+}
+
+/**
+ * @brief Register a beam bitmap and get its sprite id. Registering the same image twice returns the same id.
+ * @details The bitmap is stretched along the beam, so its left edge is drawn at the attacker and its right edge at the point of impact.
+ */
+int
+BeamSystem::load_sprite(const string &path) {
+	for(size_t i = 0; i < sprites.size(); ++i) {
+		if(sprites[i].path == path)
+			return i;
+	}
+	ImageCenter *IC = ImageCenter::get_instance();
+	sprites.push_back({path, IC->get(path)});
+	return sprites.size() - 1;
+}
+
+/**
+ * @brief Hit the target monster from p at once, and put a beam from p to the center of the target.
+ * @details The damage is sent to EventCenter the same way as a projectile hitting the target at its center, including splash, chain and status effect. Monsters are not changed here.
+ * @param sprite sprite id returned by load_sprite.
+ * @return Index of the new beam.
+ * @see ProjectileSystem::hit()
+ */
+size_t
+BeamSystem::fire(const MonsterSystem *monsters, const Point &p, size_t target, int sprite, int dmg, int effect, double splash, int chain) {
+	const Point impact{monsters->x[target], monsters->y[target]};
+	x1.emplace_back(p.x);
+	y1.emplace_back(p.y);
+	x2.emplace_back(impact.x);
+	y2.emplace_back(impact.y);
+	until.emplace_back(TimerCenter::get_instance()->get_tick() + BeamSetting::lifetime);
+	this->sprite.emplace_back(sprite);
+	const size_t i = x1.size() - 1;
+	ProjectileSystem::hit(monsters, BeamSetting::event_key | i, target, impact, dmg, effect, splash, chain);
+	return i;
+}
+
+/**
+ * @brief Drop expired beams.
+ */
+void
+BeamSystem::update() {
+	const uint64_t now = TimerCenter::get_instance()->get_tick();
+	while(head < x1.size() && until[head] <= now)
+		++head;
+	if(head == 0 || head * 2 < x1.size())
+		return;
+	const auto drop = [this](auto &v) { v.erase(v.begin(), v.begin() + head); };
+	drop(x1); drop(y1);
+	drop(x2); drop(y2);
+	drop(until);
+	drop(sprite);
+	head = 0;
+}
+
+/**
+ * @brief Draw all live beams in one batch. A beam fades out linearly over its lifetime.
+ */
+void
+BeamSystem::draw() {
+	const uint64_t now = TimerCenter::get_instance()->get_tick();
+	al_hold_bitmap_drawing(true);
+	for(size_t i = head; i < x1.size(); ++i) {
+		if(until[i] <= now) continue;
+		ALLEGRO_BITMAP *bitmap = sprites[sprite[i]].bitmap;
+		const double w = al_get_bitmap_width(bitmap);
+		const double h = al_get_bitmap_height(bitmap);
+		const double dx = x2[i] - x1[i], dy = y2[i] - y1[i];
+		// Allegro uses premultiplied alpha, so every channel of the tint fades together.
+		const float a = static_cast<float>(until[i] - now) / BeamSetting::lifetime;
+		al_draw_tinted_scaled_rotated_bitmap(
+			bitmap, al_map_rgba_f(a, a, a, a),
+			0, h / 2, x1[i], y1[i],
+			sqrt(dx * dx + dy * dy) / w, 1, atan2(dy, dx), 0);
+	}
+	al_hold_bitmap_drawing(false);
+}
+
+void
+BeamSystem::clear() {
+	x1.clear(); y1.clear();
+	x2.clear(); y2.clear();
+	until.clear();
+	sprite.clear();
+	head = 0;
+}
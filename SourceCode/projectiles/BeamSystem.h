@@ -0,0 +1,67 @@
+#ifndef BEAMSYSTEM_H_INCLUDED
+#define BEAMSYSTEM_H_INCLUDED
+
+#include <allegro5/bitmap.h>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Point;
+class MonsterSystem;
+
+/**
+ * @brief Stores the beams of hitscan attacks in pooled structure-of-arrays layout.
+ * @details A hitscan attack hits its target at once (see fire()), so a beam is only something to draw: the bitmap stretched from the attacker to the point of impact, fading out in BeamSetting::lifetime frames. Beams are never moved or tested against monsters.
+ * Every beam lives equally long and beams are appended in the order they are fired, so expired beams are always at the front. update() drops them by moving the head, and only moves the live beams to the front of the arrays when the expired part grows larger than them. The arrays never shrink, so firing a beam reuses the memory of expired ones.
+ */
+class BeamSystem
+{
+public:
+	BeamSystem() {}
+	int load_sprite(const std::string &path);
+	size_t fire(const MonsterSystem *monsters, const Point &p, size_t target, int sprite, int dmg, int effect = -1, double splash = 0, int chain = 0);
+	void update();
+	void draw();
+	void clear();
+	size_t size() const { return x1.size() - head; }
+public:
+	/**
+	 * @var x1
+	 * @brief Start point of the beam in x direction.
+	 **
+	 * @var y1
+	 * @brief Start point of the beam in y direction.
+	 **
+	 * @var x2
+	 * @brief Point of impact in x direction.
+	 **
+	 * @var y2
+	 * @brief Point of impact in y direction.
+	 **
+	 * @var until
+	 * @brief Tick of TimerCenter when the beam disappears.
+	 **
+	 * @var sprite
+	 * @brief Sprite id returned by load_sprite.
+	 */
+	std::vector<double> x1, y1;
+	std::vector<double> x2, y2;
+	std::vector<uint64_t> until;
+	std::vector<int> sprite;
+private:
+	/**
+	 * @brief Index of the first beam not expired yet.
+	 */
+	size_t head = 0;
+	struct Sprite {
+		std::string path;
+		ALLEGRO_BITMAP *bitmap;
+	};
+	/**
+	 * @brief All registered sprites, indexed by sprite id.
+	 */
+	std::vector<Sprite> sprites;
+};
+
+#endif
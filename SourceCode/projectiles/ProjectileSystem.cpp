@@ -0,0 +1,232 @@
+#include "ProjectileSystem.h"
+#include "../data/DataCenter.h"
+#include "../data/ImageCenter.h"
+#include "../data/EventCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../Utils.h"
+#include "../shapes/Shape.h"
+#include <allegro5/bitmap_draw.h>
+#include <algorithm>
+
+using namespace std;
+
+// fixed settings
+namespace ProjectileSetting {
+	// Splash damage falls linearly with the distance from the point of impact, from full damage at the point down to this fraction at the splash radius and beyond.
+	constexpr double splash_falloff = 0.25;
+	// A chain jumps to monsters within chain_range of the monster hit last, and each jump deals chain_decay of the damage of the previous one.
+	constexpr double chain_range = 100;
+	constexpr double chain_decay = 0.7;
+	constexpr int max_chain = 8;
+}
+
+/**
+ * @brief Move n projectiles along their velocity for dt seconds. A projectile never flies further than its remaining distance. The positions before the movement are kept in px and py.
+ * @details The loop has no branch and the arrays do not overlap, so the compiler is able to vectorize it.
+ */
+static void move_kernel(
+	size_t n, double dt,
+	double *__restrict x, double *__restrict y, double *__restrict px, double *__restrict py, double *__restrict remain,
+	const double *__restrict vx, const double *__restrict vy, const double *__restrict speed) {
+	for(size_t i = 0; i < n; ++i) {
+		px[i] = x[i];
+		py[i] = y[i];
+		double movement = speed[i] * dt;
+		double t = movement > 0 ? min(1., remain[i] / movement) : 0.;
+		x[i] += vx[i] * dt * t;
+		y[i] += vy[i] * dt * t;
+		remain[i] -= movement * t;
+	}
+}
+
+/**
+ * @brief Register a projectile bitmap and get its sprite id. Registering the same image twice returns the same id.
+ * @param path the image path.
+ * @param scale drawing scale of the image. The hit circle is scaled as well.
+ */
+int
+ProjectileSystem::load_sprite(const string &path, double scale) {
+	for(size_t i = 0; i < sprites.size(); ++i) {
+		if(sprites[i].path == path && sprites[i].scale == scale)
+			return i;
+	}
+	ImageCenter *IC = ImageCenter::get_instance();
+	sprites.push_back({path, scale, IC->get(path)});
+	return sprites.size() - 1;
+}
+
+/**
+ * @brief Launch a projectile from p toward target.
+ * @param sprite sprite id returned by load_sprite.
+ * @param v speed of the projectile.
+ * @param fly_dist flying distance limit of the projectile.
+ * @param effect id of the status effect put on every monster damaged, or -1 for none.
+ * @param splash radius of the splash damage, or 0 for none.
+ * @param chain number of chain jumps, at most ProjectileSetting::max_chain.
+ * @return Index of the new projectile.
+ */
+size_t
+ProjectileSystem::launch(const Point &p, const Point &target, int sprite, double v, int dmg, double fly_dist, ProjectileOwner owner_kind, int effect, double splash, int chain) {
+	ALLEGRO_BITMAP *bitmap = sprites[sprite].bitmap;
+	const Vec2 &dir = target.vec() - p.vec();
+	double d = dir.length();
+	x.emplace_back(p.x);
+	y.emplace_back(p.y);
+	px.emplace_back(p.x);
+	py.emplace_back(p.y);
+	vx.emplace_back(d > 0 ? dir.x * v / d : 0);
+	vy.emplace_back(d > 0 ? dir.y * v / d : 0);
+	speed.emplace_back(d > 0 ? v : 0);
+	remain.emplace_back(d > 0 ? fly_dist : 0);
+	r.emplace_back(min(al_get_bitmap_width(bitmap), al_get_bitmap_height(bitmap)) * sprites[sprite].scale * 0.8);
+	this->dmg.emplace_back(dmg);
+	this->effect.emplace_back(effect);
+	this->splash.emplace_back(splash);
+	this->chain.emplace_back(min(chain, ProjectileSetting::max_chain));
+	this->sprite.emplace_back(sprite);
+	this->owner_kind.emplace_back(owner_kind);
+	dead.emplace_back(false);
+	return size() - 1;
+}
+
+/**
+ * @brief Update the position and remaining flying distance of all projectiles, then mark projectiles that run out of their range as dead.
+ */
+void
+ProjectileSystem::update() {
+	update_range(0, size());
+}
+
+/**
+ * @brief Update the projectiles of indices [begin, end). Only data of these projectiles is written.
+ */
+void
+ProjectileSystem::update_range(size_t begin, size_t end) {
+	DataCenter *DC = DataCenter::get_instance();
+	move_kernel(end - begin, 1 / DC->FPS, x.data() + begin, y.data() + begin, px.data() + begin, py.data() + begin, remain.data() + begin, vx.data() + begin, vy.data() + begin, speed.data() + begin);
+	for(size_t i = begin; i < end; ++i) {
+		dead[i] |= (remain[i] <= 0);
+	}
+}
+
+/**
+ * @brief Check every projectile of indices [begin, end) against nearby live monsters along the segment it flew in this frame. A projectile that touches a monster is marked dead, and the damage is sent to EventCenter.
+ * @details Candidate monsters come from the broadphase grid of MonsterSystem: the hit boxes overlapping the circle that encloses the whole swept projectile are found by a batched test, and only they are swept exactly. Monsters are taken at their positions of this frame.
+ * A projectile stops at the first monster it touches along its flight. Among monsters touched at the same time, the one spawned earliest is hit. Splash and chain damage then spread from there, see hit().
+ * A projectile running out of its range in this frame still checks the last part of its flight.
+ * Monsters are not changed here, so ranges of projectiles could be checked on different threads.
+ */
+void
+ProjectileSystem::find_hits(const MonsterSystem *monsters, size_t begin, size_t end) {
+	for(size_t i = begin; i < end; ++i) {
+		const Circle start{px[i], py[i], r[i]};
+		const Vec2 move{x[i] - px[i], y[i] - py[i]};
+		const Circle bound{px[i] + move.x / 2, py[i] + move.y / 2, move.length() / 2 + r[i]};
+		size_t target = monsters->size();
+		double first = 1;
+		monsters->grid.query_overlap(bound, [&](size_t j) {
+			if(monsters->is_dead(j)) return;
+			double t;
+			if(!sweepOverlap(start, move, monsters->hitbox(j), t)) return;
+			if(t < first || (t == first && j < target)) target = j, first = t;
+		});
+		if(target == monsters->size()) continue;
+		hit(monsters, i, target, Point{px[i] + move.x * first, py[i] + move.y * first}, dmg[i], effect[i], splash[i], chain[i]);
+		dead[i] = true;
+	}
+}
+
+/**
+ * @brief Send the damage of a hit on the target at p to EventCenter. The events are keyed by key.
+ * @details Shared by projectiles and hitscan beams (BeamSystem).
+ * @details * The target takes the full damage.
+ * @details * With splash, every other live monster whose hit box is within the splash radius of p takes damage falling with the distance of its center from p.
+ * @details * With chain, the hit jumps from the target to the nearest monster not hit yet, again and again, with less damage every jump.
+ * @details Every monster damaged also gets the status effect, if any.
+ * @param effect id of the status effect, or -1.
+ * @param splash radius of the splash damage, or 0.
+ * @param chain number of chain jumps, at most ProjectileSetting::max_chain.
+ */
+void
+ProjectileSystem::hit(const MonsterSystem *monsters, size_t key, size_t target, const Point &p, int dmg, int effect, double splash, int chain) {
+	using namespace ProjectileSetting;
+	EventCenter *EC = EventCenter::get_instance();
+	auto damage = [&](size_t j, int value) {
+		EC->emit(EventType::DAMAGE, key, j, value);
+		if(effect != -1) EC->emit(EventType::EFFECT, key, j, effect);
+	};
+	damage(target, dmg);
+	if(splash > 0) {
+		monsters->for_each_in_radius(Circle{p.x, p.y, splash}, [&](size_t j) {
+			if(j == target) return;
+			const double d = Point::dist(p, Point{monsters->x[j], monsters->y[j]});
+			damage(j, max(1, static_cast<int>(dmg * (1 - (1 - splash_falloff) * min(1., d / splash)))));
+		});
+	}
+	size_t hops[max_chain + 1] = {target};
+	double value = dmg;
+	for(int k = 0; k < min(chain, max_chain); ++k) {
+		const size_t from = hops[k];
+		pair<double, size_t> next;
+		if(!monsters->nearest(monsters->x[from], monsters->y[from], chain_range, 1, &next, [&](size_t j) {
+			return find(hops, hops + k + 1, j) != hops + k + 1;
+		})) break;
+		value *= chain_decay;
+		hops[k + 1] = next.second;
+		damage(next.second, max(1, static_cast<int>(value)));
+	}
+}
+
+void
+ProjectileSystem::draw() {
+	for(size_t i = 0; i < size(); ++i) {
+		const Sprite &s = sprites[sprite[i]];
+		int w = al_get_bitmap_width(s.bitmap);
+		int h = al_get_bitmap_height(s.bitmap);
+		al_draw_scaled_bitmap(
+			s.bitmap,
+			0, 0, w, h,
+			x[i] - w * s.scale / 2, y[i] - h * s.scale / 2,
+			w * s.scale, h * s.scale, 0);
+	}
+}
+
+/**
+ * @brief Remove all dead projectiles in one pass.
+ */
+void
+ProjectileSystem::compact() {
+	compact_marked(x, dead);
+	compact_marked(y, dead);
+	compact_marked(px, dead);
+	compact_marked(py, dead);
+	compact_marked(vx, dead);
+	compact_marked(vy, dead);
+	compact_marked(speed, dead);
+	compact_marked(remain, dead);
+	compact_marked(r, dead);
+	compact_marked(dmg, dead);
+	compact_marked(effect, dead);
+	compact_marked(splash, dead);
+	compact_marked(chain, dead);
+	compact_marked(sprite, dead);
+	compact_marked(owner_kind, dead);
+	dead.assign(x.size(), false);
+}
+
+void
+ProjectileSystem::clear() {
+	x.clear(); y.clear();
+	px.clear(); py.clear();
+	vx.clear(); vy.clear();
+	speed.clear();
+	remain.clear();
+	r.clear();
+	dmg.clear();
+	effect.clear();
+	splash.clear();
+	chain.clear();
+	sprite.clear();
+	owner_kind.clear();
+	dead.clear();
+}
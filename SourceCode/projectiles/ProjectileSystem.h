@@ -0,0 +1,113 @@
+#ifndef PROJECTILESYSTEM_H_INCLUDED
+#define PROJECTILESYSTEM_H_INCLUDED
+
+#include "../shapes/Circle.h"
+#include <allegro5/bitmap.h>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+class Point;
+class MonsterSystem;
+
+enum class ProjectileOwner {
+	TOWER, HERO
+};
+
+/**
+ * @brief Stores all flying projectiles (tower bullets and hero rockets) in pooled structure-of-arrays layout.
+ * @details A projectile flies straight with constant velocity until it hits a monster or runs out of its range. Hits are tested along the whole segment it flew in the frame, so a fast projectile cannot pass through a monster between two frames at any frame rate. Expired and spent projectiles are only marked, and all of them are removed together by compact(). The arrays never shrink, so launching a projectile reuses the memory of removed ones.
+ * Bitmaps of projectiles are registered once as sprites, and each projectile only stores the sprite id.
+ */
+class ProjectileSystem
+{
+public:
+	ProjectileSystem() {}
+	int load_sprite(const std::string &path, double scale = 1);
+	size_t launch(const Point &p, const Point &target, int sprite, double v, int dmg, double fly_dist, ProjectileOwner owner_kind, int effect = -1, double splash = 0, int chain = 0);
+	void update();
+	void update_range(size_t begin, size_t end);
+	void find_hits(const MonsterSystem *monsters, size_t begin, size_t end);
+	void draw();
+	void compact();
+	void clear();
+	size_t size() const { return x.size(); }
+	Circle hitbox(size_t i) const { return Circle{x[i], y[i], r[i]}; }
+	static void hit(const MonsterSystem *monsters, size_t key, size_t target, const Point &p, int dmg, int effect, double splash, int chain);
+public:
+	/**
+	 * @var x
+	 * @brief Center of the projectile in x direction.
+	 **
+	 * @var y
+	 * @brief Center of the projectile in y direction.
+	 **
+	 * @var px
+	 * @brief Center of the projectile in x direction before its last movement.
+	 **
+	 * @var py
+	 * @brief Center of the projectile in y direction before its last movement.
+	 **
+	 * @var vx
+	 * @brief Velocity in x direction (pixels per second).
+	 **
+	 * @var vy
+	 * @brief Velocity in y direction (pixels per second).
+	 **
+	 * @var speed
+	 * @brief Length of the velocity vector.
+	 **
+	 * @var remain
+	 * @brief Remaining flying distance. The projectile expires when it reaches 0.
+	 **
+	 * @var r
+	 * @brief Radius of the hit circle.
+	 **
+	 * @var dmg
+	 * @brief Base damage of the projectile when hit anything.
+	 **
+	 * @var effect
+	 * @brief Id of the status effect the projectile puts on every monster it damages, or -1.
+	 * @see EffectSetting::effect_types
+	 **
+	 * @var splash
+	 * @brief Radius of the splash damage around the point of impact, or 0.
+	 **
+	 * @var chain
+	 * @brief Number of times the hit jumps on to the nearest monster not hit yet, or 0.
+	 **
+	 * @var sprite
+	 * @brief Sprite id returned by load_sprite.
+	 **
+	 * @var owner_kind
+	 * @brief Who launched the projectile.
+	 **
+	 * @var dead
+	 * @brief Whether the projectile has expired or hit a monster. Dead projectiles are removed by compact().
+	 */
+	std::vector<double> x, y;
+	std::vector<double> px, py;
+	std::vector<double> vx, vy;
+	std::vector<double> speed;
+	std::vector<double> remain;
+	std::vector<double> r;
+	std::vector<int> dmg;
+	std::vector<int> effect;
+	std::vector<double> splash;
+	std::vector<int> chain;
+	std::vector<int> sprite;
+	std::vector<ProjectileOwner> owner_kind;
+	std::vector<char> dead;
+private:
+	struct Sprite {
+		std::string path;
+		double scale;
+		ALLEGRO_BITMAP *bitmap;
+	};
+	/**
+	 * @brief All registered sprites, indexed by sprite id.
+	 */
+	std::vector<Sprite> sprites;
+};
+
+#endif
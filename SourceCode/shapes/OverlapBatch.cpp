@@ -0,0 +1,287 @@
+#include "OverlapBatch.h"
+#include "Shape.h"
+#include <algorithm>
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OVERLAP_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief The i-th box of the batch, computed the same way as MonsterSystem::hitbox().
+ */
+inline Rectangle box_of(const BoxBatch &b, size_t i) {
+	return Rectangle{b.x[i] - b.half_w[i], b.y[i] - b.half_h[i], b.x[i] + b.half_w[i], b.y[i] + b.half_h[i]};
+}
+
+/**
+ * @brief Test shapes [begin, n) one by one and set their bits. Used for CPUs without SIMD and for the tail of the SIMD kernels.
+ * @details Bits are collected in a register and written once per mask word, so consecutive tests do not wait on each other through memory.
+ */
+size_t scalar_circle_boxes(const Circle &c, const BoxBatch &b, size_t begin, size_t n, uint64_t *mask) {
+	size_t hits = 0;
+	for(size_t w = begin / 64; w * 64 < n; ++w) {
+		uint64_t bits = 0;
+		for(size_t i = std::max(begin, w * 64); i < std::min(n, w * 64 + 64); ++i)
+			bits |= uint64_t{checkOverlap(box_of(b, i), c)} << (i % 64);
+		mask[w] |= bits;
+		hits += __builtin_popcountll(bits);
+	}
+	return hits;
+}
+
+size_t scalar_box_circles(const Rectangle &r, const CircleBatch &b, size_t begin, size_t n, uint64_t *mask) {
+	size_t hits = 0;
+	for(size_t w = begin / 64; w * 64 < n; ++w) {
+		uint64_t bits = 0;
+		for(size_t i = std::max(begin, w * 64); i < std::min(n, w * 64 + 64); ++i)
+			bits |= uint64_t{checkOverlap(r, Circle{b.x[i], b.y[i], b.r[i]})} << (i % 64);
+		mask[w] |= bits;
+		hits += __builtin_popcountll(bits);
+	}
+	return hits;
+}
+
+size_t scalar_point_boxes(const Point &p, const BoxBatch &b, size_t begin, size_t n, uint64_t *mask) {
+	size_t hits = 0;
+	for(size_t w = begin / 64; w * 64 < n; ++w) {
+		uint64_t bits = 0;
+		for(size_t i = std::max(begin, w * 64); i < std::min(n, w * 64 + 64); ++i)
+			bits |= uint64_t{checkOverlap(p, box_of(b, i))} << (i % 64);
+		mask[w] |= bits;
+		hits += __builtin_popcountll(bits);
+	}
+	return hits;
+}
+
+#ifdef OVERLAP_BATCH_X86
+
+/*
+ * The SIMD kernels below follow checkOverlap() in Shape.h operation by operation:
+ * the nearest point of a box to a circle center is max(x1, min(cx, x2)), and the circle overlaps if r * r >= dx * dx + dy * dy.
+ * Multiplications and additions are kept separate (no FMA), so every lane rounds exactly as the scalar test does.
+ * Lane counts divide 64, so the bits of one SIMD step never cross a mask word. They are collected in a register and written once per word.
+ */
+
+__attribute__((target("sse2")))
+size_t sse2_circle_boxes(const Circle &c, const BoxBatch &b, size_t n, uint64_t *mask) {
+	const __m128d cx = _mm_set1_pd(c.x), cy = _mm_set1_pd(c.y), rr = _mm_set1_pd(c.r * c.r);
+	const size_t full = n - n % 2;
+	size_t hits = 0;
+	for(size_t w = 0; w * 64 < full; ++w) {
+		uint64_t word = 0;
+		for(size_t i = w * 64; i < std::min(full, w * 64 + 64); i += 2) {
+			const __m128d x = _mm_loadu_pd(b.x + i), y = _mm_loadu_pd(b.y + i);
+			const __m128d hw = _mm_loadu_pd(b.half_w + i), hh = _mm_loadu_pd(b.half_h + i);
+			const __m128d qx = _mm_max_pd(_mm_sub_pd(x, hw), _mm_min_pd(cx, _mm_add_pd(x, hw)));
+			const __m128d qy = _mm_max_pd(_mm_sub_pd(y, hh), _mm_min_pd(cy, _mm_add_pd(y, hh)));
+			const __m128d dx = _mm_sub_pd(cx, qx), dy = _mm_sub_pd(cy, qy);
+			const __m128d d2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+			const unsigned bits = _mm_movemask_pd(_mm_cmple_pd(d2, rr));
+			word |= uint64_t{bits} << (i % 64);
+		}
+		mask[w] = word;
+		hits += __builtin_popcountll(word);
+	}
+	return hits + scalar_circle_boxes(c, b, full, n, mask);
+}
+
+__attribute__((target("sse2")))
+size_t sse2_box_circles(const Rectangle &r, const CircleBatch &b, size_t n, uint64_t *mask) {
+	const __m128d x1 = _mm_set1_pd(r.x1), y1 = _mm_set1_pd(r.y1), x2 = _mm_set1_pd(r.x2), y2 = _mm_set1_pd(r.y2);
+	const size_t full = n - n % 2;
+	size_t hits = 0;
+	for(size_t w = 0; w * 64 < full; ++w) {
+		uint64_t word = 0;
+		for(size_t i = w * 64; i < std::min(full, w * 64 + 64); i += 2) {
+			const __m128d cx = _mm_loadu_pd(b.x + i), cy = _mm_loadu_pd(b.y + i), cr = _mm_loadu_pd(b.r + i);
+			const __m128d qx = _mm_max_pd(x1, _mm_min_pd(cx, x2));
+			const __m128d qy = _mm_max_pd(y1, _mm_min_pd(cy, y2));
+			const __m128d dx = _mm_sub_pd(cx, qx), dy = _mm_sub_pd(cy, qy);
+			const __m128d d2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+			const unsigned bits = _mm_movemask_pd(_mm_cmple_pd(d2, _mm_mul_pd(cr, cr)));
+			word |= uint64_t{bits} << (i % 64);
+		}
+		mask[w] = word;
+		hits += __builtin_popcountll(word);
+	}
+	return hits + scalar_box_circles(r, b, full, n, mask);
+}
+
+__attribute__((target("sse2")))
+size_t sse2_point_boxes(const Point &p, const BoxBatch &b, size_t n, uint64_t *mask) {
+	const __m128d px = _mm_set1_pd(p.x), py = _mm_set1_pd(p.y);
+	const size_t full = n - n % 2;
+	size_t hits = 0;
+	for(size_t w = 0; w * 64 < full; ++w) {
+		uint64_t word = 0;
+		for(size_t i = w * 64; i < std::min(full, w * 64 + 64); i += 2) {
+			const __m128d x = _mm_loadu_pd(b.x + i), y = _mm_loadu_pd(b.y + i);
+			const __m128d hw = _mm_loadu_pd(b.half_w + i), hh = _mm_loadu_pd(b.half_h + i);
+			const __m128d in_x = _mm_and_pd(_mm_cmple_pd(_mm_sub_pd(x, hw), px), _mm_cmple_pd(px, _mm_add_pd(x, hw)));
+			const __m128d in_y = _mm_and_pd(_mm_cmple_pd(_mm_sub_pd(y, hh), py), _mm_cmple_pd(py, _mm_add_pd(y, hh)));
+			const unsigned bits = _mm_movemask_pd(_mm_and_pd(in_x, in_y));
+			word |= uint64_t{bits} << (i % 64);
+		}
+		mask[w] = word;
+		hits += __builtin_popcountll(word);
+	}
+	return hits + scalar_point_boxes(p, b, full, n, mask);
+}
+
+__attribute__((target("avx2")))
+size_t avx2_circle_boxes(const Circle &c, const BoxBatch &b, size_t n, uint64_t *mask) {
+	const __m256d cx = _mm256_set1_pd(c.x), cy = _mm256_set1_pd(c.y), rr = _mm256_set1_pd(c.r * c.r);
+	const size_t full = n - n % 4;
+	size_t hits = 0;
+	for(size_t w = 0; w * 64 < full; ++w) {
+		uint64_t word = 0;
+		for(size_t i = w * 64; i < std::min(full, w * 64 + 64); i += 4) {
+			const __m256d x = _mm256_loadu_pd(b.x + i), y = _mm256_loadu_pd(b.y + i);
+			const __m256d hw = _mm256_loadu_pd(b.half_w + i), hh = _mm256_loadu_pd(b.half_h + i);
+			const __m256d qx = _mm256_max_pd(_mm256_sub_pd(x, hw), _mm256_min_pd(cx, _mm256_add_pd(x, hw)));
+			const __m256d qy = _mm256_max_pd(_mm256_sub_pd(y, hh), _mm256_min_pd(cy, _mm256_add_pd(y, hh)));
+			const __m256d dx = _mm256_sub_pd(cx, qx), dy = _mm256_sub_pd(cy, qy);
+			const __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+			const unsigned bits = _mm256_movemask_pd(_mm256_cmp_pd(d2, rr, _CMP_LE_OQ));
+			word |= uint64_t{bits} << (i % 64);
+		}
+		mask[w] = word;
+		hits += __builtin_popcountll(word);
+	}
+	return hits + scalar_circle_boxes(c, b, full, n, mask);
+}
+
+__attribute__((target("avx2")))
+size_t avx2_box_circles(const Rectangle &r, const CircleBatch &b, size_t n, uint64_t *mask) {
+	const __m256d x1 = _mm256_set1_pd(r.x1), y1 = _mm256_set1_pd(r.y1), x2 = _mm256_set1_pd(r.x2), y2 = _mm256_set1_pd(r.y2);
+	const size_t full = n - n % 4;
+	size_t hits = 0;
+	for(size_t w = 0; w * 64 < full; ++w) {
+		uint64_t word = 0;
+		for(size_t i = w * 64; i < std::min(full, w * 64 + 64); i += 4) {
+			const __m256d cx = _mm256_loadu_pd(b.x + i), cy = _mm256_loadu_pd(b.y + i), cr = _mm256_loadu_pd(b.r + i);
+			const __m256d qx = _mm256_max_pd(x1, _mm256_min_pd(cx, x2));
+			const __m256d qy = _mm256_max_pd(y1, _mm256_min_pd(cy, y2));
+			const __m256d dx = _mm256_sub_pd(cx, qx), dy = _mm256_sub_pd(cy, qy);
+			const __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+			const unsigned bits = _mm256_movemask_pd(_mm256_cmp_pd(d2, _mm256_mul_pd(cr, cr), _CMP_LE_OQ));
+			word |= uint64_t{bits} << (i % 64);
+		}
+		mask[w] = word;
+		hits += __builtin_popcountll(word);
+	}
+	return hits + scalar_box_circles(r, b, full, n, mask);
+}
+
+__attribute__((target("avx2")))
+size_t avx2_point_boxes(const Point &p, const BoxBatch &b, size_t n, uint64_t *mask) {
+	const __m256d px = _mm256_set1_pd(p.x), py = _mm256_set1_pd(p.y);
+	const size_t full = n - n % 4;
+	size_t hits = 0;
+	for(size_t w = 0; w * 64 < full; ++w) {
+		uint64_t word = 0;
+		for(size_t i = w * 64; i < std::min(full, w * 64 + 64); i += 4) {
+			const __m256d x = _mm256_loadu_pd(b.x + i), y = _mm256_loadu_pd(b.y + i);
+			const __m256d hw = _mm256_loadu_pd(b.half_w + i), hh = _mm256_loadu_pd(b.half_h + i);
+			const __m256d in_x = _mm256_and_pd(_mm256_cmp_pd(_mm256_sub_pd(x, hw), px, _CMP_LE_OQ), _mm256_cmp_pd(px, _mm256_add_pd(x, hw), _CMP_LE_OQ));
+			const __m256d in_y = _mm256_and_pd(_mm256_cmp_pd(_mm256_sub_pd(y, hh), py, _CMP_LE_OQ), _mm256_cmp_pd(py, _mm256_add_pd(y, hh), _CMP_LE_OQ));
+			const unsigned bits = _mm256_movemask_pd(_mm256_and_pd(in_x, in_y));
+			word |= uint64_t{bits} << (i % 64);
+		}
+		mask[w] = word;
+		hits += __builtin_popcountll(word);
+	}
+	return hits + scalar_point_boxes(p, b, full, n, mask);
+}
+
+#endif
+
+OverlapISA best_isa() {
+#ifdef OVERLAP_BATCH_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) return OverlapISA::AVX2;
+	if(__builtin_cpu_supports("sse2")) return OverlapISA::SSE2;
+#endif
+	return OverlapISA::SCALAR;
+}
+
+/**
+ * @brief The kernels in use. Chosen on first use and only lowered by set_overlap_isa().
+ */
+std::atomic<OverlapISA> &current_isa() {
+	static std::atomic<OverlapISA> isa{best_isa()};
+	return isa;
+}
+
+} // namespace
+
+/**
+ * @brief Which of the kernels is used.
+ */
+OverlapISA
+overlap_isa() {
+	return current_isa().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Use the kernels of the instruction set, or the best supported one below it. Mainly for comparing the kernels with each other.
+ * @return The instruction set actually used.
+ */
+OverlapISA
+set_overlap_isa(OverlapISA isa) {
+	isa = std::min(isa, best_isa());
+	current_isa().store(isa, std::memory_order_relaxed);
+	return isa;
+}
+
+/**
+ * @brief Test the circle against n boxes.
+ * @return Number of overlapping boxes.
+ */
+size_t
+checkOverlapBatch(const Circle &c, const BoxBatch &boxes, size_t n, uint64_t *mask) {
+	std::fill(mask, mask + overlap_mask_words(n), 0);
+	switch(overlap_isa()) {
+#ifdef OVERLAP_BATCH_X86
+		case OverlapISA::AVX2: return avx2_circle_boxes(c, boxes, n, mask);
+		case OverlapISA::SSE2: return sse2_circle_boxes(c, boxes, n, mask);
+#endif
+		default: return scalar_circle_boxes(c, boxes, 0, n, mask);
+	}
+}
+
+/**
+ * @brief Test the rectangle against n circles.
+ * @return Number of overlapping circles.
+ */
+size_t
+checkOverlapBatch(const Rectangle &r, const CircleBatch &circles, size_t n, uint64_t *mask) {
+	std::fill(mask, mask + overlap_mask_words(n), 0);
+	switch(overlap_isa()) {
+#ifdef OVERLAP_BATCH_X86
+		case OverlapISA::AVX2: return avx2_box_circles(r, circles, n, mask);
+		case OverlapISA::SSE2: return sse2_box_circles(r, circles, n, mask);
+#endif
+		default: return scalar_box_circles(r, circles, 0, n, mask);
+	}
+}
+
+/**
+ * @brief Test the point against n boxes.
+ * @return Number of boxes containing the point.
+ */
+size_t
+checkOverlapBatch(const Point &p, const BoxBatch &boxes, size_t n, uint64_t *mask) {
+	std::fill(mask, mask + overlap_mask_words(n), 0);
+	switch(overlap_isa()) {
+#ifdef OVERLAP_BATCH_X86
+		case OverlapISA::AVX2: return avx2_point_boxes(p, boxes, n, mask);
+		case OverlapISA::SSE2: return sse2_point_boxes(p, boxes, n, mask);
+#endif
+		default: return scalar_point_boxes(p, boxes, 0, n, mask);
+	}
+}
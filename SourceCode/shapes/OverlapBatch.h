@@ -0,0 +1,67 @@
+#ifndef OVERLAPBATCH_H_INCLUDED
+#define OVERLAPBATCH_H_INCLUDED
+
+#include "Point.h"
+#include "Rectangle.h"
+#include "Circle.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file OverlapBatch.h
+ * @brief Overlap tests of one shape against many shapes stored in structure-of-arrays layout.
+ * @details The result is a bitmask: bit (i % 64) of `mask[i / 64]` is set if the i-th shape overlaps. A mask of n shapes has overlap_mask_words(n) words, and the unused bits of the last word are cleared.
+ * Each test is computed with the same operations in the same order as checkOverlap() in Shape.h, so the results are identical to testing the shapes one by one.
+ * The kernels run 4 shapes at a time with AVX2 or 2 at a time with SSE2, chosen at runtime by what the CPU supports, and fall back to a scalar loop on other CPUs.
+ */
+
+/**
+ * @brief Axis-aligned boxes given by their centers and half extents, as stored by MonsterSystem. The i-th box is `Rectangle{x[i] - half_w[i], y[i] - half_h[i], x[i] + half_w[i], y[i] + half_h[i]}`.
+ */
+struct BoxBatch {
+	const double *x, *y;
+	const double *half_w, *half_h;
+	BoxBatch offset(size_t k) const { return {x + k, y + k, half_w + k, half_h + k}; }
+};
+
+/**
+ * @brief Circles given by their centers and radii, as stored by ProjectileSystem.
+ */
+struct CircleBatch {
+	const double *x, *y;
+	const double *r;
+	CircleBatch offset(size_t k) const { return {x + k, y + k, r + k}; }
+};
+
+enum class OverlapISA {
+	SCALAR, SSE2, AVX2
+};
+
+constexpr size_t overlap_mask_words(size_t n) { return (n + 63) / 64; }
+
+size_t checkOverlapBatch(const Circle &c, const BoxBatch &boxes, size_t n, uint64_t *mask);
+size_t checkOverlapBatch(const Rectangle &r, const CircleBatch &circles, size_t n, uint64_t *mask);
+size_t checkOverlapBatch(const Point &p, const BoxBatch &boxes, size_t n, uint64_t *mask);
+
+OverlapISA overlap_isa();
+OverlapISA set_overlap_isa(OverlapISA isa);
+
+/**
+ * @brief Call f(i) for every i in [begin, end) whose shape in the batch overlaps s, in increasing order.
+ * @details The range is tested in chunks with a mask on the stack, so nothing is allocated and it can be called from any thread.
+ */
+template<typename S, typename Batch, typename F>
+void forEachOverlap(const S &s, const Batch &batch, size_t begin, size_t end, F &&f) {
+	constexpr size_t chunk = 256;
+	uint64_t mask[overlap_mask_words(chunk)];
+	for(size_t k = begin; k < end; k += chunk) {
+		const size_t n = end - k < chunk ? end - k : chunk;
+		if(!checkOverlapBatch(s, batch.offset(k), n, mask)) continue;
+		for(size_t w = 0; w < overlap_mask_words(n); ++w) {
+			for(uint64_t bits = mask[w]; bits; bits &= bits - 1)
+				f(k + w * 64 + __builtin_ctzll(bits));
+		}
+	}
+}
+
+#endif
@@ -1,28 +1,27 @@
 #ifndef POINT_H_INCLUDED
 #define POINT_H_INCLUDED
 
-#include "Shape.h"
-#include <cmath>
+#include "Vec2.h"
 
 /**
- * @see Shape.cpp
+ * @brief A point, which is also used to store any 2D position in the game.
+ * @see Shape.h
  */
-class Point : public Shape
+class Point
 {
 public:
 	static double dist2(const Point &p1, const Point &p2) {
-		return (p1.x - p2.x) * (p1.x - p2.x) + (p1.y - p2.y) * (p1.y - p2.y);
+		return (p1.vec() - p2.vec()).length2();
 	}
 	static double dist(const Point &p1, const Point &p2) {
-		return std::sqrt(dist2(p1, p2));
+		return (p1.vec() - p2.vec()).length();
 	}
 public:
-	bool overlap(const Shape &s) const;
 	double center_x() const { return x; }
 	double center_y() const { return y; }
 	void update_center_x(const double &x) { this->x = x; }
 	void update_center_y(const double &y) { this->y = y; }
-	const ShapeType getType() const { return ShapeType::POINT; }
+	Vec2 vec() const { return {x, y}; }
 public:
 	Point() {}
 	Point(double x, double y) : x{x}, y{y} {}
@@ -1,15 +1,13 @@
 #ifndef RECTANGLE_H_INCLUDED
 #define RECTANGLE_H_INCLUDED
 
-#include "Shape.h"
-
 /**
- * @see Shape.cpp
+ * @brief Axis-aligned rectangle, represented by its top-left (x1, y1) and bottom-right (x2, y2) corner.
+ * @see Shape.h
  */
-class Rectangle : public Shape
+class Rectangle
 {
 public:
-	bool overlap(const Shape &s) const;
 	double center_x() const { return (x1 + x2) / 2; }
 	double center_y() const { return (y1 + y2) / 2; }
 	void update_center_x(const double &x) {
@@ -20,7 +18,6 @@ public:
 		double dy = y - center_y();
 		y1 += dy, y2 += dy;
 	}
-	const ShapeType getType() const { return ShapeType::RECTANGLE; }
 public:
 	Rectangle() {}
 	Rectangle(double x1, double y1, double x2, double y2) : x1{x1}, y1{y1}, x2{x2}, y2{y2} {}
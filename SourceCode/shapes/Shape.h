@@ -1,29 +1,107 @@
 #ifndef SHAPE_H_INCLUDED
 #define SHAPE_H_INCLUDED
 
-class Point;
-class Rectangle;
-class Circle;
+#include "Point.h"
+#include "Rectangle.h"
+#include "Circle.h"
+#include "Vec2.h"
+#include <algorithm>
+#include <cmath>
 
-enum class ShapeType {
-	POINT, RECTANGLE, CIRCLE
-};
+/**
+ * @file Shape.h
+ * @brief Overlap tests of all shapes.
+ * @details A "Shape" (Point, Rectangle or Circle) can be useful in many ways - you can treat Shape as a bounding box, attack range, colliding detection, and many other things. Basically if you want to make objects interact to each other, the Shape is indispensable.
+ * Shapes are plain values without virtual functions. The overlap test of two shapes is an overloaded inline function, so the right test is selected at compile time and can be inlined into collision loops.
+ */
+
+inline bool checkOverlap(const Point &p1, const Point &p2) {
+	return (p1.x == p2.x) && (p1.y == p2.y);
+}
+
+inline bool checkOverlap(const Point &p, const Rectangle &r) {
+	return (r.x1 <= p.x && p.x <= r.x2) && (r.y1 <= p.y && p.y <= r.y2);
+}
+
+inline bool checkOverlap(const Point &p, const Circle &c) {
+	return Point::dist2(p, Point(c.x, c.y)) <= (c.r * c.r);
+}
+
+inline bool checkOverlap(const Rectangle &r1, const Rectangle &r2) {
+	return !(r1.x2 < r2.x1 || r2.x2 < r1.x1 || r1.y2 < r2.y1 || r2.y2 < r1.y1);
+}
+
+inline bool checkOverlap(const Rectangle &r, const Circle &c) {
+	double x = std::max(r.x1, std::min(c.x, r.x2));
+	double y = std::max(r.y1, std::min(c.y, r.y2));
+	return (c.r * c.r) >= Point::dist2(Point(c.x, c.y), Point(x, y));
+}
+
+inline bool checkOverlap(const Circle &c1, const Circle &c2) {
+	double d = c1.r + c2.r;
+	return (d * d) >= Point::dist2(Point(c1.x, c1.y), Point(c2.x, c2.y));
+}
+
+inline bool checkOverlap(const Rectangle &r, const Point &p) { return checkOverlap(p, r); }
+inline bool checkOverlap(const Circle &c, const Point &p) { return checkOverlap(p, c); }
+inline bool checkOverlap(const Circle &c, const Rectangle &r) { return checkOverlap(r, c); }
+
+/**
+ * @brief Earliest time t in [0, 1] at which the point p + t * move is inside the rectangle.
+ */
+inline bool sweepOverlap(const Vec2 &p, const Vec2 &move, const Rectangle &r, double &t) {
+	double t0 = 0, t1 = 1;
+	const double from[2] = {p.x, p.y}, d[2] = {move.x, move.y};
+	const double lo[2] = {r.x1, r.y1}, hi[2] = {r.x2, r.y2};
+	for(int k = 0; k < 2; ++k) {
+		if(d[k] == 0) {
+			if(from[k] < lo[k] || hi[k] < from[k]) return false;
+			continue;
+		}
+		double ta = (lo[k] - from[k]) / d[k], tb = (hi[k] - from[k]) / d[k];
+		if(ta > tb) std::swap(ta, tb);
+		t0 = std::max(t0, ta), t1 = std::min(t1, tb);
+		if(t0 > t1) return false;
+	}
+	t = t0;
+	return true;
+}
+
+/**
+ * @brief Earliest time t in [0, 1] at which the point p + t * move is inside the circle.
+ */
+inline bool sweepOverlap(const Vec2 &p, const Vec2 &move, const Circle &c, double &t) {
+	const Vec2 f = p - Vec2{c.x, c.y};
+	const double a = move.length2(), b = f.dot(move), k = f.length2() - c.r * c.r;
+	if(k <= 0) return t = 0, true;
+	if(a == 0 || b >= 0) return false;
+	const double disc = b * b - a * k;
+	if(disc < 0) return false;
+	t = (-b - std::sqrt(disc)) / a;
+	return t <= 1;
+}
 
 /**
- * @brief Base shape class.
- * @details A "Shape" can be useful in many ways - you can treat Shape as a bounding box, attack range, colliding detection, and many other things. Basically if you want to make objects interact to each other, the Shape is indispensable.
- * @see Shape.cpp
+ * @brief Earliest time t in [0, 1] at which the circle, moved by t * move, overlaps the rectangle.
+ * @details The circle overlaps the rectangle exactly when its center is inside the rectangle rounded by the radius, which is the union of the rectangle widened by r, the rectangle heightened by r, and the circles of radius r at the four corners. The center moves along a segment, so t is the earliest entry of the segment into any of them.
+ * A circle that overlaps the rectangle at the end of the move is always reported, even if rounding misses the entry.
  */
-class Shape
-{
-public:
-	virtual bool overlap(const Shape &s) const = 0;
-	virtual double center_x() const = 0;
-	virtual double center_y() const = 0;
-	virtual void update_center_x(const double &x) = 0;
-	virtual void update_center_y(const double &y) = 0;
-	virtual const ShapeType getType() const = 0;
-	virtual ~Shape() {}
-};
+inline bool sweepOverlap(const Circle &c, const Vec2 &move, const Rectangle &r, double &t) {
+	const Vec2 p{c.x, c.y};
+	bool hit = false;
+	double best = 1, s;
+	auto take = [&](bool ok) {
+		if(ok && s <= best) best = s, hit = true;
+	};
+	take(sweepOverlap(p, move, Rectangle{r.x1 - c.r, r.y1, r.x2 + c.r, r.y2}, s));
+	take(sweepOverlap(p, move, Rectangle{r.x1, r.y1 - c.r, r.x2, r.y2 + c.r}, s));
+	take(sweepOverlap(p, move, Circle{r.x1, r.y1, c.r}, s));
+	take(sweepOverlap(p, move, Circle{r.x2, r.y1, c.r}, s));
+	take(sweepOverlap(p, move, Circle{r.x1, r.y2, c.r}, s));
+	take(sweepOverlap(p, move, Circle{r.x2, r.y2, c.r}, s));
+	if(!hit && checkOverlap(r, Circle{c.x + move.x, c.y + move.y, c.r})) best = 1, hit = true;
+	t = best;
+	return hit;
+}
 
 #endif
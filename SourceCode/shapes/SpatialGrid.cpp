@@ -0,0 +1,57 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @brief Set the size of the field and the cells. All items are cleared.
+ */
+void
+SpatialGrid::reset(double field_length, double cell_size) {
+	this->cell_size = cell_size;
+	cols = rows = max(1, static_cast<int>(ceil(field_length / cell_size)));
+	cell_start.assign(cols * rows + 1, 0);
+	items.clear();
+	margin_x = margin_y = 0;
+}
+
+/**
+ * @brief Rebuild the grid from n items. Item i is the box centered at (x[i], y[i]) with half extents (half_w[i], half_h[i]).
+ */
+void
+SpatialGrid::build(size_t n, const double *x, const double *y, const double *half_w, const double *half_h) {
+	const int cells = cols * rows;
+	cell_of.resize(n);
+	items.resize(n);
+	box_x.resize(n), box_y.resize(n), box_hw.resize(n), box_hh.resize(n);
+	fill(cell_start.begin(), cell_start.end(), 0);
+	margin_x = margin_y = 0;
+	for(size_t i = 0; i < n; ++i) {
+		cell_of[i] = cell_y(y[i]) * cols + cell_x(x[i]);
+		++cell_start[cell_of[i] + 1];
+		margin_x = max(margin_x, half_w[i]);
+		margin_y = max(margin_y, half_h[i]);
+	}
+	for(int c = 0; c < cells; ++c)
+		cell_start[c + 1] += cell_start[c];
+	// Scatter items into their cells. cell_start[c] is used as the write cursor of cell c and restored afterward.
+	for(size_t i = 0; i < n; ++i) {
+		const size_t k = cell_start[cell_of[i]]++;
+		items[k] = i;
+		box_x[k] = x[i], box_y[k] = y[i], box_hw[k] = half_w[i], box_hh[k] = half_h[i];
+	}
+	for(int c = cells; c > 0; --c)
+		cell_start[c] = cell_start[c - 1];
+	cell_start[0] = 0;
+}
+
+int
+SpatialGrid::cell_x(double x) const {
+	return min(cols - 1, max(0, static_cast<int>(floor(x / cell_size))));
+}
+
+int
+SpatialGrid::cell_y(double y) const {
+	return min(rows - 1, max(0, static_cast<int>(floor(y / cell_size))));
+}
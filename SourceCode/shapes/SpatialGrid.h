@@ -0,0 +1,133 @@
+#ifndef SPATIALGRID_H_INCLUDED
+#define SPATIALGRID_H_INCLUDED
+
+#include "Rectangle.h"
+#include "Circle.h"
+#include "OverlapBatch.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+/**
+ * @brief Uniform grid (spatial hash) over a square field for broadphase collision detection.
+ * @details Every item is stored in the cell that contains its center. A query visits the cells overlapping the query box enlarged by the largest half extent among the items, so every item that may overlap the box is visited exactly once, and the narrow-phase test only runs on items in the same or neighbouring cells.
+ * The grid is rebuilt from scratch with a counting sort, which is linear in the number of items and cells and does not allocate once the buffers have grown. The boxes are copied in the sorted order as well, so the items of neighbouring cells in a row can be tested by one checkOverlapBatch() call.
+ */
+class SpatialGrid
+{
+public:
+	SpatialGrid() {}
+	void reset(double field_length, double cell_size);
+	void build(size_t n, const double *x, const double *y, const double *half_w, const double *half_h);
+	/**
+	 * @brief Call f(i) for every item i that may overlap the box.
+	 */
+	template<typename F>
+	void query(const Rectangle &box, F &&f) const {
+		if(cell_start.empty()) return;
+		int x1 = cell_x(box.x1 - margin_x), x2 = cell_x(box.x2 + margin_x);
+		int y1 = cell_y(box.y1 - margin_y), y2 = cell_y(box.y2 + margin_y);
+		for(int cy = y1; cy <= y2; ++cy) {
+			for(int cx = x1; cx <= x2; ++cx) {
+				int c = cy * cols + cx;
+				for(size_t k = cell_start[c]; k < cell_start[c + 1]; ++k)
+					f(items[k]);
+			}
+		}
+	}
+	/**
+	 * @brief Call f(i) for every item i whose box overlaps the circle, in the order of the cells.
+	 */
+	template<typename F>
+	void query_overlap(const Circle &c, F &&f) const {
+		if(cell_start.empty()) return;
+		int x1 = cell_x(c.x - c.r - margin_x), x2 = cell_x(c.x + c.r + margin_x);
+		int y1 = cell_y(c.y - c.r - margin_y), y2 = cell_y(c.y + c.r + margin_y);
+		const BoxBatch boxes{box_x.data(), box_y.data(), box_hw.data(), box_hh.data()};
+		for(int cy = y1; cy <= y2; ++cy) {
+			// Cells x1 to x2 of a row are consecutive in items.
+			forEachOverlap(c, boxes, cell_start[cy * cols + x1], cell_start[cy * cols + x2 + 1], [&](size_t k) {
+				f(items[k]);
+			});
+		}
+	}
+	/**
+	 * @brief Find up to k items nearest to (x, y) by the distance to their centers, within max_r and not rejected by skip(i).
+	 * @details Rings of cells around the cell of (x, y) are visited outward. An item in the d-th ring is at least (d - 1) cells away, so the search stops once that is farther than the k-th item found or max_r. Items at the same distance are ordered by index.
+	 * @param out receives (squared distance, item) pairs, nearest first. It must have room for k pairs.
+	 * @return Number of items found.
+	 */
+	template<typename F>
+	size_t nearest(double x, double y, double max_r, size_t k, std::pair<double, size_t> *out, F &&skip) const {
+		if(cell_start.empty() || k == 0) return 0;
+		const int cx = cell_x(x), cy = cell_y(y);
+		const double max_r2 = max_r * max_r;
+		size_t found = 0;
+		for(int d = 0; d <= std::max(cols, rows); ++d) {
+			const double bound = std::max(0, d - 1) * cell_size;
+			if(bound > max_r || (found == k && bound * bound > out[k - 1].first)) break;
+			for(int gy = cy - d; gy <= cy + d; ++gy) {
+				if(gy < 0 || gy >= rows) continue;
+				// Only the border of the ring: every cell of the top and bottom rows, and the two ends of other rows.
+				const int step = (gy == cy - d || gy == cy + d) ? 1 : std::max(1, 2 * d);
+				for(int gx = cx - d; gx <= cx + d; gx += step) {
+					if(gx < 0 || gx >= cols) continue;
+					const int c = gy * cols + gx;
+					for(size_t t = cell_start[c]; t < cell_start[c + 1]; ++t) {
+						const double dx = box_x[t] - x, dy = box_y[t] - y;
+						const std::pair<double, size_t> cand{dx * dx + dy * dy, items[t]};
+						if(cand.first > max_r2 || (found == k && !(cand < out[k - 1])) || skip(cand.second)) continue;
+						// Insert into the sorted result, dropping the farthest one if it is full.
+						size_t p = found < k ? found++ : k - 1;
+						for(; p > 0 && cand < out[p - 1]; --p)
+							out[p] = out[p - 1];
+						out[p] = cand;
+					}
+				}
+			}
+		}
+		return found;
+	}
+private:
+	int cell_x(double x) const;
+	int cell_y(double y) const;
+private:
+	/**
+	 * @var cell_size
+	 * @brief Side length of a cell.
+	 **
+	 * @var cols
+	 * @brief Number of cells in x-direction. Items outside the field are clamped into the border cells.
+	 **
+	 * @var rows
+	 * @brief Number of cells in y-direction.
+	 **
+	 * @var margin_x
+	 * @brief Largest half width among the items of the last build.
+	 **
+	 * @var margin_y
+	 * @brief Largest half height among the items of the last build.
+	 **
+	 * @var cell_start
+	 * @brief Items of cell c are `items[cell_start[c]]` to `items[cell_start[c+1]-1]`.
+	 **
+	 * @var items
+	 * @brief Item indices sorted by cell.
+	 **
+	 * @var cell_of
+	 * @brief Cell of each item in the last build.
+	 **
+	 * @var box_x
+	 * @brief Center and half extents of the box of `items[k]` at index k.
+	 */
+	double cell_size = 1;
+	int cols = 0, rows = 0;
+	double margin_x = 0, margin_y = 0;
+	std::vector<size_t> cell_start;
+	std::vector<size_t> items;
+	std::vector<int> cell_of;
+	std::vector<double> box_x, box_y, box_hw, box_hh;
+};
+
+#endif
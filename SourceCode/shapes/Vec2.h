@@ -0,0 +1,21 @@
+#ifndef VEC2_H_INCLUDED
+#define VEC2_H_INCLUDED
+
+#include <cmath>
+
+/**
+ * @brief Plain 2D vector for position and velocity math.
+ * @details Vec2 has no virtual function and no heap data, so it can be freely copied and kept in registers.
+ */
+struct Vec2
+{
+	double x, y;
+	constexpr Vec2 operator+(const Vec2 &v) const { return {x + v.x, y + v.y}; }
+	constexpr Vec2 operator-(const Vec2 &v) const { return {x - v.x, y - v.y}; }
+	constexpr Vec2 operator*(double k) const { return {x * k, y * k}; }
+	constexpr double dot(const Vec2 &v) const { return x * v.x + y * v.y; }
+	constexpr double length2() const { return dot(*this); }
+	double length() const { return std::sqrt(length2()); }
+};
+
+#endif
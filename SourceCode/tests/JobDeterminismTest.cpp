@@ -0,0 +1,129 @@
+#include "TestUtils.h"
+#include "../Player.h"
+#include "../data/JobCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../projectiles/ProjectileSystem.h"
+#include "../towers/Tower.h"
+#include "../towers/TowerSystem.h"
+#include "../towers/TowerCoverage.h"
+#include "../towers/EngagementScheduler.h"
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+
+using namespace std;
+
+// fixed settings
+namespace JobDeterminismTestSetting {
+	constexpr int level = 3;
+	// one tower of each TowerType
+	constexpr double tower_x[] = {100, 300, 500, 200, 400};
+	constexpr double tower_y[] = {200, 200, 200, 440, 440};
+	// every burst_interval ticks until burst_until, burst_count monsters spawn at once on top of the waves
+	constexpr int burst_interval = 10;
+	constexpr int burst_until = 300;
+	constexpr size_t burst_count = 40;
+	constexpr int max_ticks = 20000;
+	constexpr unsigned min_workers = 3;
+	constexpr size_t line_length = 64;
+}
+
+/**
+ * @brief FNV-1a hash of the state of a tick.
+ */
+class StateHash {
+public:
+	template<typename T>
+	void add(const vector<T> &v) { add(v.data(), v.size() * sizeof(T)); }
+	void add(const void *p, size_t n) {
+		const unsigned char *c = static_cast<const unsigned char*>(p);
+		for(size_t i = 0; i < n; ++i)
+			h = (h ^ c[i]) * 1099511628211ULL;
+	}
+	uint64_t get() const { return h; }
+private:
+	uint64_t h = 1469598103934665603ULL;
+};
+
+/**
+ * @brief Play the scenario with the given number of workers and print the hash of the monsters, projectiles and player after every tick.
+ */
+static int play(size_t workers) {
+	using namespace JobDeterminismTestSetting;
+	JobCenter::get_instance()->init(workers);
+	test_init();
+	DataCenter *DC = DataCenter::get_instance();
+	DC->level->load_level(JobDeterminismTestSetting::level);
+	DC->player->HP = 1000;
+	for(int k = 0; k < static_cast<int>(TowerType::TOWERTYPE_MAX); ++k) {
+		const TowerType type = static_cast<TowerType>(k);
+		const Point p{tower_x[k], tower_y[k]};
+		// the region a tower blocks when placed by UI
+		ALLEGRO_BITMAP *bitmap = Tower::get_bitmap(type);
+		const int w = al_get_bitmap_width(bitmap), h = al_get_bitmap_height(bitmap);
+		GAME_ASSERT(DC->level->block_region(Rectangle{p.x - w / 2, p.y - h / 2, p.x + w / 2, p.y + h / 2}), "tower %d traps the start.", k);
+		Tower *tower = DC->towers->add(type, p);
+		DC->coverage->add_tower(tower);
+		DC->engagement->add_tower(tower);
+	}
+
+	MonsterSystem *monsters = DC->monsters;
+	ProjectileSystem *projectiles = DC->projectiles;
+	for(int tick = 1; tick <= max_ticks; ++tick) {
+		if(tick % burst_interval == 0 && tick <= burst_until) {
+			const MonsterType type = static_cast<MonsterType>(tick / burst_interval % static_cast<int>(MonsterType::MONSTERTYPE_MAX));
+			size_t first = monsters->spawn(type, burst_count);
+			for(size_t id = first; id < first + burst_count; ++id)
+				DC->engagement->schedule_monster(id);
+		}
+		test_step();
+		StateHash h;
+		h.add(monsters->x); h.add(monsters->y);
+		h.add(monsters->dist); h.add(monsters->HP);
+		h.add(monsters->uid); h.add(monsters->poison);
+		h.add(projectiles->x); h.add(projectiles->y);
+		h.add(projectiles->dmg);
+		h.add(&DC->player->HP, sizeof(DC->player->HP));
+		h.add(&DC->player->coin, sizeof(DC->player->coin));
+		printf("%d %zu %zu %016llx\n", tick, monsters->size(), projectiles->size(), static_cast<unsigned long long>(h.get()));
+		if(DC->level->remain_monsters() == 0 && monsters->empty()) break;
+	}
+	return 0;
+}
+
+/**
+ * @brief Replay the same level in two processes, one without workers and one with several, and compare their states after every tick.
+ * @details Each run is a child process running this program with the number of workers as its argument, since the timers of a level could not be rewound within one process. Everything the runs print is compared, including the messages of the game.
+ */
+int main(int argc, char **argv) {
+	using namespace JobDeterminismTestSetting;
+	if(argc > 1) return play(strtoul(argv[1], nullptr, 10));
+
+	const unsigned workers = max(min_workers, thread::hardware_concurrency());
+	FILE *serial = popen((string(argv[0]) + " 0").c_str(), "r");
+	FILE *parallel = popen((string(argv[0]) + " " + to_string(workers)).c_str(), "r");
+	GAME_ASSERT(serial != nullptr && parallel != nullptr, "failed to run %s.", argv[0]);
+	char a[line_length], b[line_length];
+	int lines = 0;
+	while(true) {
+		const bool more_a = fgets(a, sizeof(a), serial) != nullptr;
+		const bool more_b = fgets(b, sizeof(b), parallel) != nullptr;
+		CHECK(more_a == more_b, "the runs end at different lines after line %d.", lines);
+		if(!more_a || !more_b) break;
+		++lines;
+		if(string(a) != string(b)) {
+			CHECK(false, "line %d differs with %u workers.\n  0 workers: %s  %u workers: %s", lines, workers, a, workers, b);
+			break;
+		}
+	}
+	// Let the runs finish before waiting for them.
+	while(fgets(a, sizeof(a), serial) != nullptr) {}
+	while(fgets(b, sizeof(b), parallel) != nullptr) {}
+	CHECK(pclose(serial) == 0, "the run without workers failed.");
+	CHECK(pclose(parallel) == 0, "the run with %u workers failed.", workers);
+	CHECK(lines > 0, "the runs printed nothing.");
+	printf("%d lines compared with 0 and %u workers.\n", lines, workers);
+	return test_result("JobDeterminismTest");
+}
@@ -0,0 +1,88 @@
+#include "TestUtils.h"
+#include "../Player.h"
+#include "../FlowField.h"
+#include "../monsters/MonsterSystem.h"
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+// fixed settings
+namespace OpenMapTestSetting {
+	// assets/level/LEVEL3.txt: an open map from grid (0, 1) to grid (14, 13)
+	constexpr int level = 3;
+	constexpr int wall_x = 7;
+	constexpr int gap_y = 7;
+	constexpr int max_ticks = 20000;
+}
+
+/**
+ * @brief Load the sample open map, wall it off except for one gap, and let every monster walk to the end.
+ * @details Checks that the route follows the flow field, that placements which would trap the start are rejected by both the preview and the click, that blocking grids one by one gives the same distances as blocking them all at once, and that every monster leaves the field.
+ */
+int main() {
+	using namespace OpenMapTestSetting;
+	test_init();
+	DataCenter *DC = DataCenter::get_instance();
+	Level *level = DC->level;
+	level->load_level(OpenMapTestSetting::level);
+	CHECK(level->is_open_map(), "LEVEL%d should be an open map.", OpenMapTestSetting::level);
+
+	const FlowField &flow = level->get_flow_field();
+	const int start = level->get_start_cell();
+	const int w = flow.get_width();
+	auto check_route = [&]() {
+		const vector<Point> &route = level->get_road_path();
+		CHECK(!route.empty(), "the goal should be reachable.");
+		if(route.empty()) return;
+		CHECK(level->grid_to_cell(route.front()) == start, "the route should start at the start.");
+		CHECK(level->grid_to_cell(route.back()) == flow.get_goal(), "the route should end at the goal.");
+		CHECK(static_cast<int>(route.size()) == flow.distance(start) + 1, "the route has %zu grids, but the start is %d steps away.", route.size(), flow.distance(start));
+		for(size_t k = 1; k < route.size(); ++k) {
+			const double step = fabs(route[k].x - route[k - 1].x) + fabs(route[k].y - route[k - 1].y);
+			CHECK(step == 1, "grids %zu and %zu of the route are not neighbours.", k - 1, k);
+		}
+	};
+	check_route();
+
+	// A wall along column wall_x with a single gap at row gap_y.
+	const int g = level->get_grid_size();
+	const Rectangle upper{wall_x * g, 0, (wall_x + 1) * g, gap_y * g};
+	const Rectangle lower{wall_x * g, (gap_y + 1) * g, (wall_x + 1) * g, flow.get_height() * g};
+	const Rectangle gap{wall_x * g, gap_y * g, (wall_x + 1) * g, (gap_y + 1) * g};
+	CHECK(level->can_block(upper), "the upper wall leaves the start connected.");
+	CHECK(level->block_region(upper), "the upper wall leaves the start connected.");
+	CHECK(level->can_block(lower), "the lower wall leaves the start connected.");
+	CHECK(level->block_region(lower), "the lower wall leaves the start connected.");
+	CHECK(!level->can_block(gap), "blocking the gap would trap the start.");
+	CHECK(!level->block_region(gap), "blocking the gap would trap the start.");
+	check_route();
+
+	// Blocking grids one region at a time should give the same distances as blocking all of them at once.
+	vector<int> walls;
+	for(int y = 0; y < flow.get_height(); ++y)
+		if(y != gap_y) walls.emplace_back(y * w + wall_x);
+	FlowField fresh;
+	fresh.reset(w, flow.get_height(), flow.get_goal());
+	fresh.block(walls);
+	for(int c = 0; c < w * flow.get_height(); ++c)
+		CHECK(flow.distance(c) == fresh.distance(c), "grid %d is %d steps away, but %d when blocked at once.", c, flow.distance(c), fresh.distance(c));
+
+	// Without towers, every monster should leak or run into the hero.
+	DC->player->HP = 1000;
+	const int total = level->remain_monsters();
+	int ticks = 0;
+	while(ticks < max_ticks && (level->remain_monsters() || !DC->monsters->empty())) {
+		test_step();
+		++ticks;
+	}
+	CHECK(ticks < max_ticks, "monsters are still walking after %d ticks.", ticks);
+	const EventStats &stats = EventCenter::get_instance()->get_stats();
+	int kills = 0, leaks = 0;
+	for(int v : stats.kills) kills += v;
+	for(int v : stats.leaks) leaks += v;
+	CHECK(kills == 0, "%d monsters are killed without towers.", kills);
+	// Bosses may summon more monsters than the level spawns.
+	CHECK(leaks + stats.contacts >= total, "%d leaks and %d contacts of %d monsters.", leaks, stats.contacts, total);
+	return test_result("OpenMapTest");
+}
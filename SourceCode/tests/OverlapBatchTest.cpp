@@ -0,0 +1,90 @@
+#include "TestUtils.h"
+#include "../shapes/Shape.h"
+#include "../shapes/OverlapBatch.h"
+#include <vector>
+#include <random>
+
+using namespace std;
+
+// fixed settings
+namespace OverlapBatchTestSetting {
+	// tails of every width for 2 and 4 lanes, and around whole mask words
+	constexpr size_t sizes[] = {0, 1, 2, 3, 4, 5, 7, 63, 64, 65, 127, 128, 130, 257};
+	constexpr int queries = 50;
+	// Coordinates are small integers, so many shapes touch exactly at their borders.
+	constexpr int field_length = 40;
+	constexpr int max_extent = 8;
+	constexpr OverlapISA isas[] = {OverlapISA::SCALAR, OverlapISA::SSE2, OverlapISA::AVX2};
+	constexpr const char *isa_names[] = {"scalar", "SSE2", "AVX2"};
+}
+
+/**
+ * @brief Compare a mask of n shapes against the expected results, and check that the count matches and the unused bits are cleared.
+ */
+static void check_mask(const vector<uint64_t> &mask, const vector<char> &expected, size_t hits, const char *what, const char *isa) {
+	const size_t n = expected.size();
+	size_t count = 0;
+	for(size_t i = 0; i < n; ++i) {
+		const bool bit = (mask[i / 64] >> (i % 64)) & 1;
+		CHECK(bit == static_cast<bool>(expected[i]), "%s with %s: shape %zu of %zu is %d but checkOverlap() says %d.", what, isa, i, n, bit, expected[i]);
+		count += expected[i];
+	}
+	CHECK(hits == count, "%s with %s: %zu hits of %zu shapes, but checkOverlap() finds %zu.", what, isa, hits, n, count);
+	if(n % 64) CHECK((mask[n / 64] >> (n % 64)) == 0, "%s with %s: unused bits of the mask of %zu shapes are set.", what, isa, n);
+}
+
+/**
+ * @brief Every kernel of checkOverlapBatch() against checkOverlap() on each shape, for sizes with every possible tail.
+ * @details Kernels the CPU does not support are skipped, since set_overlap_isa() falls back to the best supported one. The mask is filled with set bits beforehand, so stale bits would show up.
+ */
+int main() {
+	using namespace OverlapBatchTestSetting;
+	mt19937 rng(2024);
+	uniform_int_distribution<int> pos(0, field_length), extent(0, max_extent);
+	for(size_t k = 0; k < size(isas); ++k) {
+		if(set_overlap_isa(isas[k]) != isas[k]) {
+			printf("%s is not supported by this CPU, skipped.\n", isa_names[k]);
+			continue;
+		}
+		for(size_t n : sizes) {
+			vector<double> x(n), y(n), half_w(n), half_h(n), r(n);
+			for(size_t i = 0; i < n; ++i) {
+				x[i] = pos(rng), y[i] = pos(rng);
+				half_w[i] = extent(rng), half_h[i] = extent(rng), r[i] = extent(rng);
+			}
+			const BoxBatch boxes{x.data(), y.data(), half_w.data(), half_h.data()};
+			const CircleBatch circles{x.data(), y.data(), r.data()};
+			vector<uint64_t> mask(overlap_mask_words(n) + 1);
+			vector<char> expected(n);
+			for(int q = 0; q < queries; ++q) {
+				const Circle c{pos(rng), pos(rng), extent(rng)};
+				for(size_t i = 0; i < n; ++i)
+					expected[i] = checkOverlap(c, Rectangle{x[i] - half_w[i], y[i] - half_h[i], x[i] + half_w[i], y[i] + half_h[i]});
+				fill(mask.begin(), mask.end(), ~0ULL);
+				check_mask(mask, expected, checkOverlapBatch(c, boxes, n, mask.data()), "circle against boxes", isa_names[k]);
+
+				const Rectangle rect{pos(rng), pos(rng), pos(rng) + extent(rng), pos(rng) + extent(rng)};
+				for(size_t i = 0; i < n; ++i)
+					expected[i] = checkOverlap(rect, Circle{x[i], y[i], r[i]});
+				fill(mask.begin(), mask.end(), ~0ULL);
+				check_mask(mask, expected, checkOverlapBatch(rect, circles, n, mask.data()), "box against circles", isa_names[k]);
+
+				const Point p{pos(rng), pos(rng)};
+				for(size_t i = 0; i < n; ++i)
+					expected[i] = checkOverlap(p, Rectangle{x[i] - half_w[i], y[i] - half_h[i], x[i] + half_w[i], y[i] + half_h[i]});
+				fill(mask.begin(), mask.end(), ~0ULL);
+				check_mask(mask, expected, checkOverlapBatch(p, boxes, n, mask.data()), "point against boxes", isa_names[k]);
+
+				// A range starting in the middle of the arrays, as used by SpatialGrid and the systems.
+				if(n < 2) continue;
+				vector<size_t> found;
+				forEachOverlap(p, boxes, 1, n, [&](size_t i) { found.emplace_back(i); });
+				vector<size_t> want;
+				for(size_t i = 1; i < n; ++i)
+					if(expected[i]) want.emplace_back(i);
+				CHECK(found == want, "forEachOverlap() with %s on [1, %zu) finds %zu boxes instead of %zu.", isa_names[k], n, found.size(), want.size());
+			}
+		}
+	}
+	return test_result("OverlapBatchTest");
+}
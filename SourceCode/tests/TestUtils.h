@@ -0,0 +1,81 @@
+#ifndef TESTUTILS_H_INCLUDED
+#define TESTUTILS_H_INCLUDED
+
+#include "../Utils.h"
+#include "../data/DataCenter.h"
+#include "../data/TimerCenter.h"
+#include "../data/OperationCenter.h"
+#include "../data/EventCenter.h"
+#include "../data/SoundCenter.h"
+#include "../hero/Hero.h"
+#include "../Level.h"
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_image.h>
+#include <allegro5/allegro_audio.h>
+#include <allegro5/allegro_acodec.h>
+#include <cstdio>
+
+/**
+ * @file TestUtils.h
+ * @brief Helpers shared by the tests of `make test`.
+ * @details Every test is a small program linked with the objects of the game. It runs from the source directory, so levels, images and sounds are loaded from ./assets as in the game. A test prints every failed check and returns non-zero if any check failed.
+ */
+
+/**
+ * @brief Number of failed checks so far.
+ */
+inline int test_failures = 0;
+
+/**
+ * @brief Check a condition. If it does not hold, print where the check is and the custom message, and count the failure.
+ * @details Unlike GAME_ASSERT, the test goes on, so one run reports every failed check. The custom message accepts printf format.
+ */
+#define CHECK(condition, ...) { \
+	if(!(condition)) { \
+		fprintf(stderr, "Check failed at line %d in file %s: %s\n", __LINE__, __FILE__, #condition); \
+		fprintf(stderr, "Message: "); \
+		fprintf(stderr, __VA_ARGS__); \
+		fputc('\n', stderr); \
+		++test_failures; \
+	} \
+}
+
+/**
+ * @brief Initialize the allegro addons that loading a level needs and the game body, without a display.
+ * @details Bitmaps loaded without a display are memory bitmaps, which is enough for hit boxes. The hero is the first role, as in the headless game.
+ */
+inline void test_init() {
+	GAME_ASSERT(al_init(), "failed to initialize allegro.");
+	bool addon_init = true;
+	addon_init &= al_init_image_addon();
+	addon_init &= al_install_audio();
+	addon_init &= al_init_acodec_addon();
+	GAME_ASSERT(addon_init, "failed to initialize allegro addons.");
+	SoundCenter::get_instance()->init();
+	DataCenter *DC = DataCenter::get_instance();
+	DC->level->init();
+	DC->hero->init(1);
+}
+
+/**
+ * @brief Advance the game by one fixed simulation step, as Game::game_step() does in a level.
+ */
+inline void test_step() {
+	DataCenter *DC = DataCenter::get_instance();
+	TimerCenter::get_instance()->update();
+	DC->hero->update();
+	OperationCenter::get_instance()->update();
+	EventCenter::get_instance()->reduce();
+}
+
+/**
+ * @brief Print the result of the test.
+ * @return The exit code of the test: 0 if every check passed.
+ */
+inline int test_result(const char *name) {
+	if(test_failures) fprintf(stderr, "%s: %d checks failed.\n", name, test_failures);
+	else printf("%s: passed.\n", name);
+	return test_failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include "TestUtils.h"
+#include "../Player.h"
+#include "../monsters/MonsterSystem.h"
+#include <utility>
+
+using namespace std;
+
+// fixed settings
+namespace WaveTestSetting {
+	// assets/level/WAVE3.txt replaces the monster counts of assets/level/LEVEL3.txt
+	constexpr int level = 3;
+	constexpr int total = 12 + 4 + 10 + 1;
+	// (tick, number of monsters spawned by the end of that tick), ticks counted from loading the level
+	constexpr pair<int, int> spawned_at[] = {
+		{29, 0}, {30, 3}, {44, 3}, {45, 4}, {60, 7}, {75, 8}, {90, 11}, {105, 12}, {120, 15},
+		{135, 16}, {329, 16}, {330, 21}, {339, 21}, {340, 26}, {389, 26}, {390, 27}, {400, 27}
+	};
+}
+
+/**
+ * @brief Load the sample wave file and count the monsters spawned by the end of each interesting tick.
+ * @details Covers comments, the delay of waves, the delay, interval and burst of groups, and groups of the same wave interleaving.
+ */
+int main() {
+	using namespace WaveTestSetting;
+	test_init();
+	DataCenter *DC = DataCenter::get_instance();
+	Level *level = DC->level;
+	level->load_level(WaveTestSetting::level);
+	CHECK(level->remain_monsters() == total, "the wave file has %d monsters, but %d are loaded.", total, level->remain_monsters());
+
+	// Monsters should not leave the field before the last spawn.
+	DC->player->HP = 1000;
+	int tick = 0;
+	for(const auto &[t, spawned] : spawned_at) {
+		for(; tick < t; ++tick)
+			test_step();
+		CHECK(total - level->remain_monsters() == spawned, "%d monsters should be spawned by tick %d, but %d are.", spawned, t, total - level->remain_monsters());
+		CHECK(DC->monsters->size() == static_cast<size_t>(spawned), "%d monsters should be on the field at tick %d, but %zu are.", spawned, t, DC->monsters->size());
+	}
+	return test_result("WaveTest");
+}
@@ -0,0 +1,190 @@
+#include "EngagementScheduler.h"
+#include "Tower.h"
+#include "TowerSystem.h"
+#include "../Level.h"
+#include "../data/DataCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../data/TimerCenter.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @brief Clear all pending events and recompute the spans of every existing tower for the current level.
+ */
+void
+EngagementScheduler::reset() {
+	DataCenter *DC = DataCenter::get_instance();
+	active = !DC->level->is_open_map();
+	events = decltype(events){};
+	generation.clear();
+	engaged_by.clear();
+	engagements.clear();
+	for(Tower *tower : *DC->towers) {
+		DC->towers->engaged(tower) = 0;
+		add_tower(tower);
+	}
+}
+
+/**
+ * @brief Compute the road spans within range of a newly placed tower, and schedule the monsters already walking.
+ */
+void
+EngagementScheduler::add_tower(Tower *tower) {
+	if(!active) return;
+	DataCenter *DC = DataCenter::get_instance();
+	MonsterSystem *monsters = DC->monsters;
+	engagements.push_back({tower, _spans_of(tower)});
+	for(size_t i = 0; i < monsters->size(); ++i) {
+		if(monsters->is_dead(i)) continue;
+		_schedule_monster(engagements.back(), i);
+	}
+}
+
+/**
+ * @brief Schedule the enter and leave events of the i-th monster for every tower. Called when the monster spawns.
+ * @details The id of the monster may have belonged to a monster that died, whose events are retired first.
+ */
+void
+EngagementScheduler::schedule_monster(size_t i) {
+	if(!active) return;
+	DataCenter *DC = DataCenter::get_instance();
+	MonsterSystem *monsters = DC->monsters;
+	_retire(monsters->uid[i]);
+	for(const Engagement &e : engagements)
+		_schedule(e, monsters->uid[i], monsters->dist[i], monsters->speed[i]);
+}
+
+/**
+ * @brief Schedule the i-th monster again from its current distance. Called when a status effect changes its pace.
+ * @details Events scheduled before are retired, so each tower is engaged by the monster only as its new pace predicts.
+ */
+void
+EngagementScheduler::reschedule_monster(size_t i) {
+	if(!active) return;
+	_retire(DataCenter::get_instance()->monsters->uid[i]);
+	for(const Engagement &e : engagements)
+		_schedule_monster(e, i);
+}
+
+/**
+ * @brief Release the towers engaged by the monster of id uid, and make its pending events stale by moving to a new generation.
+ */
+void
+EngagementScheduler::_retire(size_t uid) {
+	_track(uid);
+	TowerSystem *towers = DataCenter::get_instance()->towers;
+	for(Tower *tower : engaged_by[uid])
+		--towers->engaged(tower);
+	engaged_by[uid].clear();
+	++generation[uid];
+}
+
+/**
+ * @brief Make room for the generation and engaged towers of the monster of id uid.
+ */
+void
+EngagementScheduler::_track(size_t uid) {
+	if(uid < generation.size()) return;
+	generation.resize(uid + 1, 0);
+	engaged_by.resize(uid + 1);
+}
+
+/**
+ * @brief Schedule the i-th monster with its current pace for the spans of a tower.
+ * @details A stunned monster does not move. Towers whose spans contain it stay engaged until the stun ends, when the monster is scheduled again by reschedule_monster().
+ */
+void
+EngagementScheduler::_schedule_monster(const Engagement &e, size_t i) {
+	const MonsterSystem *monsters = DataCenter::get_instance()->monsters;
+	const size_t uid = monsters->uid[i];
+	const double dist = monsters->dist[i];
+	_track(uid);
+	if(monsters->pace[i] > 0) {
+		_schedule(e, uid, dist, monsters->speed[i] * monsters->pace[i]);
+		return;
+	}
+	const long long now = TimerCenter::get_instance()->get_tick();
+	const long long hold = max(0LL, static_cast<long long>(monsters->stunned_until(i)) - now);
+	for(const Span &span : e.spans) {
+		if(span.enter > dist || span.leave < dist) continue;
+		events.push({tick, e.tower, +1, uid, generation[uid]});
+		events.push({tick + hold + 1, e.tower, -1, uid, generation[uid]});
+	}
+}
+
+/**
+ * @brief Move to the next tick and apply all events due.
+ * @details Called every frame right before towers update. Stale events are dropped.
+ */
+void
+EngagementScheduler::advance() {
+	TowerSystem *towers = DataCenter::get_instance()->towers;
+	while(!events.empty() && events.top().tick <= tick) {
+		const Event e = events.top();
+		events.pop();
+		if(e.generation != generation[e.uid]) continue;
+		vector<Tower*> &engaged = engaged_by[e.uid];
+		if(e.delta > 0) {
+			engaged.emplace_back(e.tower);
+		} else {
+			// Enter events come first, so the tower is always found.
+			auto it = find(engaged.begin(), engaged.end(), e.tower);
+			*it = engaged.back();
+			engaged.pop_back();
+		}
+		towers->engaged(e.tower) += e.delta;
+	}
+	++tick;
+}
+
+/**
+ * @brief Spans of the road polyline within range of the tower, widened by the largest monster hit box.
+ * @details On each segment `p + u * t`, the center of a monster is in the widened range while `|p + u * t - c| <= R`, which is a quadratic inequality of t. Touching spans of consecutive segments are merged.
+ */
+vector<EngagementScheduler::Span>
+EngagementScheduler::_spans_of(const Tower *tower) const {
+	DataCenter *DC = DataCenter::get_instance();
+	const RoadPolyline &poly = DC->level->get_road_polyline();
+	// No corner of a hit box is farther from the center of the monster than the largest half-extents loaded.
+	const double R = tower->shape.r + hypot(Monster::get_max_half_w(), Monster::get_max_half_h());
+	vector<Span> res;
+	for(size_t k = 0; k + 1 < poly.s.size(); ++k) {
+		double len = poly.s[k + 1] - poly.s[k];
+		if(len <= 0) continue;
+		double px = poly.x[k] - tower->shape.x, py = poly.y[k] - tower->shape.y;
+		// t^2 + 2bt + c <= 0
+		double b = poly.ux[k] * px + poly.uy[k] * py;
+		double c = px * px + py * py - R * R;
+		double disc = b * b - c;
+		if(disc < 0) continue;
+		double t1 = max(0., -b - sqrt(disc));
+		double t2 = min(len, -b + sqrt(disc));
+		if(t1 > t2) continue;
+		Span span{poly.s[k] + t1, poly.s[k] + t2};
+		if(!res.empty() && res.back().leave >= span.enter)
+			res.back().leave = max(res.back().leave, span.leave);
+		else
+			res.emplace_back(span);
+	}
+	return res;
+}
+
+/**
+ * @brief Push the enter and leave events of a monster at distance dist with the speed for the spans of a tower.
+ * @details The monster moves before towers update, so at the j-th tick from now it is at `dist + (j + 1) * step`.
+ */
+void
+EngagementScheduler::_schedule(const Engagement &e, size_t uid, double dist, double speed) {
+	DataCenter *DC = DataCenter::get_instance();
+	const double step = speed / DC->FPS;
+	if(step <= 0) return;
+	for(const Span &span : e.spans) {
+		if(span.leave < dist) continue;
+		long long enter = max(0LL, static_cast<long long>(ceil((span.enter - dist) / step)) - 2);
+		long long leave = static_cast<long long>(floor((span.leave - dist) / step)) + 1;
+		events.push({tick + enter, e.tower, +1, uid, generation[uid]});
+		events.push({tick + leave, e.tower, -1, uid, generation[uid]});
+	}
+}
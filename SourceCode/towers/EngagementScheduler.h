@@ -0,0 +1,84 @@
+#ifndef ENGAGEMENTSCHEDULER_H_INCLUDED
+#define ENGAGEMENTSCHEDULER_H_INCLUDED
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+class Tower;
+
+/**
+ * @brief Predicts when monsters enter and leave the range of each tower, so that towers only look for targets while some monster is in range.
+ * @details On a fixed road, a monster walks along the road polyline at constant speed, and a tower is a static circle. For every tower, the scheduler precomputes the spans of the road (in arc length) that are within the range of the tower. When a monster spawns (or a tower is placed), the ticks at which the monster enters and leaves each span are computed directly, and pushed as events into a priority queue keyed by tick.
+ * Every tick, the due events update Tower::engaged, the number of monsters predicted in range. A tower with no engaged monster skips target acquisition. Monsters that die before leaving a span are not tracked: their leave event still arrives on time (or the towers are released when a new monster takes the id), and the tower only wakes up for nothing in between.
+ * The prediction is conservative: spans are widened by the farthest corner of the largest hit box among the loaded monster types (see Monster::load_types()), and entry and leave ticks are widened by one tick. On an open map routes may change at any time, so the scheduler is inactive and towers always look for targets.
+ * A status effect changing the pace of a monster breaks its prediction, so the monster is scheduled again from where it is with its new pace. Events are stamped with the id of the monster and its generation, which is bumped whenever the monster is scheduled again: the towers the monster engaged are released at once, and the events of older generations are dropped when they come due.
+ * @see Tower::engaged
+ */
+class EngagementScheduler
+{
+public:
+	EngagementScheduler() {}
+	void reset();
+	void add_tower(Tower *tower);
+	void schedule_monster(size_t i);
+	void reschedule_monster(size_t i);
+	void advance();
+	bool is_active() const { return active; }
+private:
+	struct Span {
+		double enter, leave;
+	};
+	struct Engagement {
+		Tower *tower;
+		std::vector<Span> spans;
+	};
+	struct Event {
+		long long tick;
+		Tower *tower;
+		int delta;
+		size_t uid;
+		uint32_t generation;
+		// Enter events of a tick are applied before its leave events, so a leave event always finds its enter event applied.
+		bool operator>(const Event &rhs) const {
+			if(tick != rhs.tick) return tick > rhs.tick;
+			return delta < rhs.delta;
+		}
+	};
+	std::vector<Span> _spans_of(const Tower *tower) const;
+	void _schedule(const Engagement &e, size_t uid, double dist, double speed);
+	void _schedule_monster(const Engagement &e, size_t i);
+	void _retire(size_t uid);
+	void _track(size_t uid);
+private:
+	/**
+	 * @var active
+	 * @brief Whether monsters walk on a fixed road, so that their movement can be predicted.
+	 **
+	 * @var tick
+	 * @brief Number of advance() calls so far.
+	 **
+	 * @var engagements
+	 * @brief Road spans within range of each tower.
+	 **
+	 * @var events
+	 * @brief Pending enter (+1) and leave (-1) events, earliest first.
+	 **
+	 * @var generation
+	 * @brief Current generation of the events of each monster id. Events of other generations are stale.
+	 **
+	 * @var engaged_by
+	 * @brief Towers engaged by each monster id: enter events applied whose leave events have not been.
+	 */
+	bool active = false;
+	long long tick = 0;
+	std::vector<Engagement> engagements;
+	std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+	std::vector<uint32_t> generation;
+	std::vector<std::vector<Tower*>> engaged_by;
+};
+
+#endif
@@ -3,39 +3,69 @@
 
 #include "../Object.h"
 #include "../shapes/Rectangle.h"
+#include "../shapes/Circle.h"
+#include "../shapes/Point.h"
+#include "../monsters/StatusEffect.h"
 #include <allegro5/bitmap.h>
-#include <string>
+#include <string_view>
 #include <array>
-
-class Bullet;
+#include <vector>
+#include <cstddef>
 
 // fixed settings
 enum class TowerType {
 	ARCANE, ARCHER, CANON, POISON, STORM, TOWERTYPE_MAX
 };
-namespace TowerSetting {
-	const std::array<std::string, static_cast<int>(TowerType::TOWERTYPE_MAX)> tower_full_img_path = {
-		"./assets/image/tower/Arcane.png",
-		"./assets/image/tower/Archer.png",
-		"./assets/image/tower/Canon.png",
-		"./assets/image/tower/Poison.png",
-		"./assets/image/tower/Storm.png"
-	};
-	const std::array<std::string, static_cast<int>(TowerType::TOWERTYPE_MAX)> tower_menu_img_path = {
-		"./assets/image/tower/Arcane_Menu.png",
-		"./assets/image/tower/Archer_Menu.png",
-		"./assets/image/tower/Canon_Menu.png",
-		"./assets/image/tower/Poison_Menu.png",
-		"./assets/image/tower/Storm_Menu.png"
-	};
-	const std::array<std::string, static_cast<int>(TowerType::TOWERTYPE_MAX)> tower_bullet_img_path = {
-		"./assets/image/tower/Arcane_Beam.png",
-		"./assets/image/tower/Archer_Beam.png",
-		"./assets/image/tower/Canon_Beam.png",
-		"./assets/image/tower/Poison_Beam.png",
-		"./assets/image/tower/Storm_Beam.png"
-	};
-	const std::array<int, static_cast<int>(TowerType::TOWERTYPE_MAX)> tower_price = {50, 100, 150, 200, 250};
+/**
+ * @brief How a tower chooses one monster among all monsters in its range.
+ * @details FIRST: the monster furthest along the road path. STRONGEST: the monster with the most HP. CLOSEST: the monster nearest to the tower. Ties are broken by path progress.
+ */
+enum class TargetPolicy {
+	FIRST, STRONGEST, CLOSEST
+};
+/**
+ * @brief How an attack of a tower reaches its target.
+ * @details PROJECTILE: a bullet flies toward the target and hits the first monster on its way. HITSCAN: the target is hit at once, and only a beam is drawn.
+ */
+enum class AttackMode {
+	PROJECTILE, HITSCAN
+};
+class Tower;
+
+/**
+ * @brief Everything that defines a TowerType.
+ * @details TowerSystem reads the row of a type as compile-time constants when it updates the towers of the type. Types with special behaviour specialize the update of TowerSystem for the type.
+ **
+ * @var attack_mode
+ * @brief Whether the tower launches bullets or hits its target at once. A hitscan tower draws its bullet image as a beam, and ignores bullet_speed.
+ **
+ * @var effect
+ * @brief Id of the status effect bullets of the type put on monsters, or EffectSetting::none.
+ **
+ * @var splash
+ * @brief Radius of the splash damage of a bullet around its point of impact, or 0.
+ **
+ * @var chain
+ * @brief Number of times the hit of a bullet jumps on to a nearby monster, or 0.
+ **
+ * @var create
+ * @brief Creates a tower of the type at a point.
+ */
+struct TowerInfo {
+	std::string_view full_img_path;
+	std::string_view menu_img_path;
+	std::string_view bullet_img_path;
+	int price;
+	TargetPolicy target_policy;
+	double attack_range;
+	int attack_freq;
+	AttackMode attack_mode;
+	double bullet_speed;
+	int bullet_dmg;
+	int effect;
+	double splash;
+	int chain;
+	Tower *(*create)(const Point &p, TowerType type);
 };
 
 class Tower : public Object
@@ -51,27 +81,58 @@ public:
 	 * @param p center point of the tower.
 	 */
 	static Tower *create_tower(TowerType type, const Point &p);
+	static const TowerInfo &get_info(TowerType type);
 public:
-	Tower(const Point &p, double attack_range, int attack_freq, TowerType type);
+	Tower(const Point &p, TowerType type);
 	virtual ~Tower() {}
-	void update();
-	virtual bool attack(Object *target);
 	void draw();
 	Rectangle get_region() const;
-	virtual Bullet *create_bullet(Object *target) = 0;
-	virtual const double attack_range() const = 0;
+	double attack_range() const { return get_info(type).attack_range; }
 	TowerType type;
-private:
 	/**
-	 * @var attack_freq
-	 * @brief Tower attack frequency. This variable will be set by its child classes.
-	 **
-	 * @var counter
-	 * @brief Tower attack cooldown.
+	 * @brief Index of the tower in the bucket of its type in TowerSystem. Per-frame states of the tower (cooldown, engagement, target) are stored there.
+	 * @see TowerSystem
 	 */
-	int attack_freq;
-	int counter;
+	size_t slot = 0;
+	/**
+	 * @brief The tower's defending region. If any monster walks into this area (i.e. the bounding box of the monster and defending region of the tower has overlap), the tower should attack.
+	 */
+	Circle shape;
+	/**
+	 * @brief Road cells covered by the defending region, filled by TowerCoverage::add_tower().
+	 * @see TowerCoverage
+	 */
+	std::vector<int> covered_cells;
+private:
 	ALLEGRO_BITMAP *bitmap;
 };
 
+/**
+ * @brief Factory of TowerInfo::create.
+ */
+template<typename T>
+Tower *make_tower(const Point &p, TowerType type) {
+	return new T(p, type);
+}
+
+// fixed settings
+namespace TowerSetting {
+	/**
+	 * @brief TowerInfo of every TowerType, indexed by the type. A new type only needs a new row here.
+	 */
+	inline constexpr std::array<TowerInfo, static_cast<int>(TowerType::TOWERTYPE_MAX)> tower_types = {{
+		// full image, menu image, bullet image, price, target policy, range, attack freq, attack mode, bullet speed, bullet damage, status effect, splash radius, chain jumps, factory
+		{"./assets/image/tower/Arcane.png", "./assets/image/tower/Arcane_Menu.png", "./assets/image/tower/Arcane_Beam.png", 50, TargetPolicy::FIRST, 160, 60, AttackMode::HITSCAN, 480, 4, EffectSetting::none, 0, 0, make_tower<Tower>},
+		{"./assets/image/tower/Archer.png", "./assets/image/tower/Archer_Menu.png", "./assets/image/tower/Archer_Beam.png", 100, TargetPolicy::FIRST, 160, 36, AttackMode::PROJECTILE, 480, 4, EffectSetting::none, 0, 0, make_tower<Tower>},
+		{"./assets/image/tower/Canon.png", "./assets/image/tower/Canon_Menu.png", "./assets/image/tower/Canon_Beam.png", 150, TargetPolicy::STRONGEST, 200, 120, AttackMode::PROJECTILE, 300, 20, EffectSetting::stun, 60, 0, make_tower<Tower>},
+		{"./assets/image/tower/Poison.png", "./assets/image/tower/Poison_Menu.png", "./assets/image/tower/Poison_Beam.png", 200, TargetPolicy::FIRST, 150, 30, AttackMode::PROJECTILE, 480, 6, EffectSetting::poison, 0, 0, make_tower<Tower>},
+		{"./assets/image/tower/Storm.png", "./assets/image/tower/Storm_Menu.png", "./assets/image/tower/Storm_Beam.png", 250, TargetPolicy::CLOSEST, 150, 4, AttackMode::HITSCAN, 360, 1, EffectSetting::slow, 0, 3, make_tower<Tower>}
+	}};
+}
+
+inline const TowerInfo&
+Tower::get_info(TowerType type) {
+	return TowerSetting::tower_types[static_cast<int>(type)];
+}
+
 #endif
@@ -0,0 +1,116 @@
+#include "TowerCoverage.h"
+#include "Tower.h"
+#include "TowerSystem.h"
+#include "../Level.h"
+#include "../data/DataCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../shapes/Shape.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Rebuild the road cells from the current level. Towers that already exist are added again.
+ */
+void
+TowerCoverage::reset() {
+	DataCenter *DC = DataCenter::get_instance();
+	const vector<Point> &path = DC->level->get_road_path();
+	grid_size = DC->level->get_grid_size();
+	grid_w = grid_h = DC->game_field_length / grid_size;
+	cell_of_grid.assign(grid_w * grid_h, -1);
+	path_cell.clear();
+	cell_grid.clear();
+	cell_towers.clear();
+	// On an open map monsters may walk on any grid.
+	if(DC->level->is_open_map()) {
+		for(int c = 0; c < grid_w * grid_h; ++c) {
+			cell_of_grid[c] = c;
+			cell_grid.emplace_back(DC->level->cell_to_grid(c));
+			cell_towers.emplace_back();
+		}
+	}
+	for(const Point &p : path) {
+		int &id = cell_of_grid[static_cast<int>(p.y) * grid_w + static_cast<int>(p.x)];
+		if(id == -1) {
+			id = cell_towers.size();
+			cell_grid.emplace_back(p);
+			cell_towers.emplace_back();
+		}
+		path_cell.emplace_back(id);
+	}
+	cell_start.assign(cell_towers.size() + 1, 0);
+	items.clear();
+	for(Tower *tower : *DC->towers)
+		add_tower(tower);
+}
+
+/**
+ * @brief Find the road cells covered by the newly placed tower and add the tower to them.
+ * @details A monster registered on a cell has its center in the cell, so its hit box lies within the cell widened by the largest hit box extents of all monster types.
+ * @see Monster::get_max_half_w()
+ */
+void
+TowerCoverage::add_tower(Tower *tower) {
+	DataCenter *DC = DataCenter::get_instance();
+	const double margin_x = Monster::get_max_half_w(), margin_y = Monster::get_max_half_h();
+	tower->covered_cells.clear();
+	for(size_t c = 0; c < cell_grid.size(); ++c) {
+		Rectangle region = DC->level->grid_to_region(cell_grid[c]);
+		region.x1 -= margin_x; region.y1 -= margin_y;
+		region.x2 += margin_x; region.y2 += margin_y;
+		if(!checkOverlap(region, tower->shape)) continue;
+		tower->covered_cells.emplace_back(c);
+		cell_towers[c].emplace_back(tower);
+	}
+}
+
+/**
+ * @brief Register every monster to the road cell it stands on. Monsters on cells that no tower covers are skipped.
+ * @details The registration is a counting sort by road cell, and monsters in the same cell keep their spawn order. It is valid until the next MonsterSystem::compact().
+ */
+void
+TowerCoverage::register_monsters(const MonsterSystem *monsters) {
+	const size_t n = monsters->size();
+	const size_t cells = cell_towers.size();
+	monster_cell.resize(n);
+	fill(cell_start.begin(), cell_start.end(), 0);
+	size_t m = 0;
+	for(size_t i = 0; i < n; ++i) {
+		int c = _road_cell(monsters, i);
+		if(c != -1 && cell_towers[c].empty()) c = -1;
+		monster_cell[i] = c;
+		if(c == -1) continue;
+		++cell_start[c + 1];
+		++m;
+	}
+	for(size_t c = 0; c < cells; ++c)
+		cell_start[c + 1] += cell_start[c];
+	// Scatter monsters into their cells. cell_start[c] is used as the write cursor of cell c and restored afterward.
+	items.resize(m);
+	box_x.resize(m), box_y.resize(m), box_hw.resize(m), box_hh.resize(m);
+	for(size_t i = 0; i < n; ++i) {
+		if(monster_cell[i] == -1) continue;
+		const size_t k = cell_start[monster_cell[i]]++;
+		items[k] = i;
+		box_x[k] = monsters->x[i], box_y[k] = monsters->y[i];
+		box_hw[k] = monsters->half_w[i], box_hh[k] = monsters->half_h[i];
+	}
+	for(size_t c = cells; c > 0; --c)
+		cell_start[c] = cell_start[c - 1];
+	cell_start[0] = 0;
+}
+
+/**
+ * @brief Road cell containing the center of the i-th monster.
+ * @details A monster cutting a corner between two diagonal road grids may stand outside the road for a moment. It is then counted on the road grid it came from.
+ */
+int
+TowerCoverage::_road_cell(const MonsterSystem *monsters, size_t i) const {
+	if(path_cell.empty()) return -1;
+	int gx = static_cast<int>(monsters->x[i]) / grid_size;
+	int gy = static_cast<int>(monsters->y[i]) / grid_size;
+	if(0 <= gx && gx < grid_w && 0 <= gy && gy < grid_h && cell_of_grid[gy * grid_w + gx] != -1)
+		return cell_of_grid[gy * grid_w + gx];
+	return path_cell[monsters->seg[i]];
+}
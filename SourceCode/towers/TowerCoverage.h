@@ -0,0 +1,94 @@
+#ifndef TOWERCOVERAGE_H_INCLUDED
+#define TOWERCOVERAGE_H_INCLUDED
+
+#include "../shapes/Point.h"
+#include "../shapes/Circle.h"
+#include "../shapes/OverlapBatch.h"
+#include <vector>
+#include <cstddef>
+
+class Tower;
+class MonsterSystem;
+
+/**
+ * @brief Index between road cells, towers and monsters for target acquisition.
+ * @details Monsters only walk on the road (or, on an open map, on any grid), so a tower only needs to look at the road cells its attack range covers. For each distinct road cell, the index keeps the towers covering it, and every tick the monsters are registered to the road cell they stand on. A tower then only visits the monsters of its covered cells instead of all monsters.
+ * A tower covers a road cell if its attack range overlaps the cell widened by the largest hit box half extents among all monster types (Monster::get_max_half_w() and Monster::get_max_half_h()), so the hit box of a monster standing on the cell is never missed, however large its sprite is. The exact overlap test is still done by the tower.
+ * @see Tower::covered_cells
+ */
+class TowerCoverage
+{
+public:
+	TowerCoverage() {}
+	void reset();
+	void add_tower(Tower *tower);
+	void register_monsters(const MonsterSystem *monsters);
+	/**
+	 * @brief Call f(i) for every monster i standing on the road cell.
+	 */
+	template<typename F>
+	void for_each_monster(int cell, F &&f) const {
+		for(size_t k = cell_start[cell]; k < cell_start[cell + 1]; ++k)
+			f(items[k]);
+	}
+	/**
+	 * @brief Call f(i) for every monster i standing on the road cell whose hit box overlaps the circle.
+	 * @details The hit boxes of the cell are tested together by checkOverlapBatch().
+	 */
+	template<typename F>
+	void for_each_monster(int cell, const Circle &c, F &&f) const {
+		const BoxBatch boxes{box_x.data(), box_y.data(), box_hw.data(), box_hh.data()};
+		forEachOverlap(c, boxes, cell_start[cell], cell_start[cell + 1], [&](size_t k) {
+			f(items[k]);
+		});
+	}
+private:
+	int _road_cell(const MonsterSystem *monsters, size_t i) const;
+private:
+	/**
+	 * @var grid_w
+	 * @brief Number of grids in x-direction of the level.
+	 **
+	 * @var grid_h
+	 * @brief Number of grids in y-direction of the level.
+	 **
+	 * @var grid_size
+	 * @brief Side length of a grid of the level.
+	 **
+	 * @var cell_of_grid
+	 * @brief Road cell id of each grid (y * grid_w + x), or -1 if the grid is not on the road.
+	 **
+	 * @var path_cell
+	 * @brief Road cell id of each point of the road path.
+	 **
+	 * @var cell_grid
+	 * @brief Grid of each road cell.
+	 **
+	 * @var cell_towers
+	 * @brief Towers covering each road cell.
+	 **
+	 * @var cell_start
+	 * @brief Monsters on road cell c are `items[cell_start[c]]` to `items[cell_start[c+1]-1]`.
+	 **
+	 * @var items
+	 * @brief Monster indices sorted by road cell. Only cells covered by at least one tower are filled.
+	 **
+	 * @var monster_cell
+	 * @brief Road cell of each monster in the last registration, or -1 if no tower covers it.
+	 **
+	 * @var box_x
+	 * @brief Center and half extents of the hit box of monster `items[k]` at index k.
+	 */
+	int grid_w = 0, grid_h = 0;
+	int grid_size = 1;
+	std::vector<int> cell_of_grid;
+	std::vector<int> path_cell;
+	std::vector<Point> cell_grid;
+	std::vector<std::vector<Tower*>> cell_towers;
+	std::vector<size_t> cell_start;
+	std::vector<size_t> items;
+	std::vector<int> monster_cell;
+	std::vector<double> box_x, box_y, box_hw, box_hh;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "TowerSystem.h"
+#include "TowerCoverage.h"
+#include "EngagementScheduler.h"
+#include "../data/DataCenter.h"
+#include "../data/SoundCenter.h"
+#include "../monsters/MonsterSystem.h"
+#include "../projectiles/ProjectileSystem.h"
+#include "../projectiles/BeamSystem.h"
+#include "../shapes/Circle.h"
+#include "../shapes/Point.h"
+#include <string>
+
+// fixed settings
+namespace TowerSetting {
+	constexpr char attack_sound_path[] = "./assets/sound/Arrow.wav";
+	constexpr size_t type_count = static_cast<size_t>(TowerType::TOWERTYPE_MAX);
+};
+
+/**
+ * @brief Decide which towers of a bucket look for a target: a tower out of cooldown looks if a monster is predicted in its range, or always if no prediction is available (idle).
+ * @details The loop has no branch and the arrays do not overlap, so the compiler is able to vectorize it.
+ */
+static void wants_kernel(size_t n, char idle, const char *__restrict ready, const int *__restrict engaged, char *__restrict wants) {
+	for(size_t i = 0; i < n; ++i)
+		wants[i] = ready[i] & ((engaged[i] > 0) | idle);
+}
+
+TowerSystem::~TowerSystem() {
+	clear();
+}
+
+/**
+ * @brief Create a tower of the type at p and append it to the bucket of the type.
+ * @details The bullet image of the type is loaded when the first tower of the type is placed, as a projectile sprite or as a beam sprite by the attack mode of the type.
+ */
+Tower*
+TowerSystem::add(TowerType type, const Point &p) {
+	Tower *tower = Tower::create_tower(type, p);
+	Bucket &b = buckets[static_cast<int>(type)];
+	if(b.bullet_sprite == -1) {
+		DataCenter *DC = DataCenter::get_instance();
+		const TowerInfo &info = Tower::get_info(type);
+		b.bullet_sprite = info.attack_mode == AttackMode::HITSCAN
+			? DC->beams->load_sprite(std::string{info.bullet_img_path})
+			: DC->projectiles->load_sprite(std::string{info.bullet_img_path});
+	}
+	tower->slot = b.towers.size();
+	b.towers.emplace_back(tower);
+	b.ready.emplace_back(true);
+	b.engaged.emplace_back(0);
+	b.wants.emplace_back(false);
+	b.target.emplace_back(-1);
+	b.cooldown_timer.emplace_back(0);
+	towers.emplace_back(tower);
+	return tower;
+}
+
+/**
+ * @brief Remove all towers and cancel their cooldown timers.
+ */
+void
+TowerSystem::clear() {
+	TimerCenter *TC = TimerCenter::get_instance();
+	for(Bucket &b : buckets) {
+		for(TimerHandle timer : b.cooldown_timer)
+			TC->cancel(timer);
+		b.towers.clear();
+		b.ready.clear();
+		b.engaged.clear();
+		b.wants.clear();
+		b.target.clear();
+		b.cooldown_timer.clear();
+	}
+	for(Tower *tower : towers)
+		delete tower;
+	towers.clear();
+}
+
+/**
+ * @brief Pick the target of every tower of the type, without changing anything outside the bucket.
+ * @details Buckets do not share any state, so different types can be aimed at the same time.
+ */
+void
+TowerSystem::aim(TowerType type) {
+	static constexpr std::array<Kernel, TowerSetting::type_count> table = _aim_table(std::make_index_sequence<TowerSetting::type_count>{});
+	(this->*table[static_cast<int>(type)])();
+}
+
+/**
+ * @brief Every tower with a target attacks it, type by type and in placement order within a type.
+ */
+void
+TowerSystem::fire() {
+	static constexpr std::array<Kernel, TowerSetting::type_count> table = _fire_table(std::make_index_sequence<TowerSetting::type_count>{});
+	for(Kernel kernel : table)
+		(this->*kernel)();
+}
+
+template<TowerType T>
+void
+TowerSystem::_aim() {
+	constexpr TowerInfo info = TowerSetting::tower_types[static_cast<int>(T)];
+	Bucket &b = buckets[static_cast<int>(T)];
+	const size_t n = b.towers.size();
+	if(n == 0) return;
+	const char idle = !DataCenter::get_instance()->engagement->is_active();
+	wants_kernel(n, idle, b.ready.data(), b.engaged.data(), b.wants.data());
+	for(size_t i = 0; i < n; ++i)
+		b.target[i] = b.wants[i] ? _pick_target<info.target_policy>(b.towers[i], info.attack_range) : -1;
+}
+
+/**
+ * @details The bullet flies from the center of the tower to the center of the target as far as the attack range. A hitscan tower instead hits the target at once and leaves a beam. The tower can attack again after attack_freq frames.
+ */
+template<TowerType T>
+void
+TowerSystem::_fire() {
+	constexpr TowerInfo info = TowerSetting::tower_types[static_cast<int>(T)];
+	Bucket &b = buckets[static_cast<int>(T)];
+	DataCenter *DC = DataCenter::get_instance();
+	MonsterSystem *monsters = DC->monsters;
+	for(size_t i = 0; i < b.towers.size(); ++i) {
+		if(b.target[i] == -1) continue;
+		const Circle &shape = b.towers[i]->shape;
+		const Point from{shape.center_x(), shape.center_y()};
+		if constexpr(info.attack_mode == AttackMode::HITSCAN) {
+			DC->beams->fire(monsters, from, b.target[i], b.bullet_sprite, info.bullet_dmg, info.effect, info.splash, info.chain);
+		} else {
+			const Rectangle &box = monsters->hitbox(b.target[i]);
+			DC->projectiles->launch(
+				from, Point{box.center_x(), box.center_y()},
+				b.bullet_sprite, info.bullet_speed, info.bullet_dmg, info.attack_range, ProjectileOwner::TOWER, info.effect, info.splash, info.chain);
+		}
+		SoundCenter::get_instance()->play_effect(TowerSetting::attack_sound_path);
+		b.ready[i] = false;
+		b.target[i] = -1;
+		b.cooldown_timer[i] = TimerCenter::get_instance()->schedule(info.attack_freq + 1, [this, i]() {
+			buckets[static_cast<int>(T)].ready[i] = true;
+		});
+	}
+}
+
+/**
+ * @brief Choose a target by the policy among the monsters in range.
+ * @details Only monsters registered on the covered cells of the tower are visited.
+ * @return Index of the target monster in MonsterSystem, or -1 if no monster is in range.
+ * @see TowerCoverage
+ */
+template<TargetPolicy P>
+int
+TowerSystem::_pick_target(const Tower *tower, double range) const {
+	DataCenter *DC = DataCenter::get_instance();
+	const MonsterSystem *monsters = DC->monsters;
+	const Circle shape{tower->shape.x, tower->shape.y, range};
+	int target = -1;
+	double best = 0;
+	for(int cell : tower->covered_cells) {
+		DC->coverage->for_each_monster(cell, shape, [&](size_t i) {
+			if(monsters->is_dead(i)) return;
+			double key = 0;
+			if constexpr(P == TargetPolicy::STRONGEST) key = monsters->HP[i];
+			if constexpr(P == TargetPolicy::CLOSEST) key = -Point::dist2(Point{monsters->x[i], monsters->y[i]}, Point{shape.x, shape.y});
+			if(target == -1 || key > best || (key == best && monsters->is_ahead(i, target))) {
+				target = i;
+				best = key;
+			}
+		});
+	}
+	return target;
+}
@@ -0,0 +1,87 @@
+#ifndef TOWERSYSTEM_H_INCLUDED
+#define TOWERSYSTEM_H_INCLUDED
+
+#include "Tower.h"
+#include "../data/TimerCenter.h"
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Owns all placed towers and updates them type by type.
+ * @details Towers of each TowerType are kept in a bucket, whose per-frame states (cooldown, engagement, target) are stored in contiguous arrays. The update of a bucket is a function template on the TowerType, so the attack range, frequency, target policy and bullet of the type are compile-time constants from TowerSetting::tower_types, and the cooldown and engagement checks of a whole bucket run as one branch-free loop.
+ * Iterating the system visits all towers in the order they were placed.
+ * @see Tower
+ */
+class TowerSystem
+{
+public:
+	TowerSystem() {}
+	~TowerSystem();
+	Tower *add(TowerType type, const Point &p);
+	void clear();
+	void aim(TowerType type);
+	void fire();
+	int &engaged(const Tower *tower) { return buckets[static_cast<int>(tower->type)].engaged[tower->slot]; }
+	size_t size() const { return towers.size(); }
+	std::vector<Tower*>::const_iterator begin() const { return towers.begin(); }
+	std::vector<Tower*>::const_iterator end() const { return towers.end(); }
+private:
+	template<TowerType T> void _aim();
+	template<TowerType T> void _fire();
+	template<TargetPolicy P> int _pick_target(const Tower *tower, double range) const;
+	using Kernel = void (TowerSystem::*)();
+	/**
+	 * @brief _aim<T>() of every TowerType, indexed by the type.
+	 */
+	template<size_t... I>
+	static constexpr std::array<Kernel, sizeof...(I)> _aim_table(std::index_sequence<I...>) {
+		return {&TowerSystem::_aim<static_cast<TowerType>(I)>...};
+	}
+	/**
+	 * @brief _fire<T>() of every TowerType, indexed by the type.
+	 */
+	template<size_t... I>
+	static constexpr std::array<Kernel, sizeof...(I)> _fire_table(std::index_sequence<I...>) {
+		return {&TowerSystem::_fire<static_cast<TowerType>(I)>...};
+	}
+	/**
+	 * @var towers
+	 * @brief Towers of the type, in the order they were placed. A tower is at `towers[tower->slot]`.
+	 **
+	 * @var ready
+	 * @brief Whether the attack cooldown is over.
+	 **
+	 * @var engaged
+	 * @brief Number of monsters predicted to be in range, maintained by EngagementScheduler. The tower only looks for a target if it is positive.
+	 **
+	 * @var wants
+	 * @brief Whether the tower looks for a target in this frame.
+	 **
+	 * @var target
+	 * @brief Index of the monster the tower attacks in this frame, or -1.
+	 **
+	 * @var cooldown_timer
+	 * @brief Timer setting ready after an attack.
+	 **
+	 * @var bullet_sprite
+	 * @brief Sprite id of the bullet image of the type in ProjectileSystem, or in BeamSystem for a hitscan type, or -1 before the first tower of the type is placed.
+	 */
+	struct Bucket {
+		std::vector<Tower*> towers;
+		std::vector<char> ready;
+		std::vector<int> engaged;
+		std::vector<char> wants;
+		std::vector<int> target;
+		std::vector<TimerHandle> cooldown_timer;
+		int bullet_sprite = -1;
+	};
+	std::array<Bucket, static_cast<int>(TowerType::TOWERTYPE_MAX)> buckets;
+	/**
+	 * @brief All towers in the order they were placed.
+	 */
+	std::vector<Tower*> towers;
+};
+
+#endif